@@ -0,0 +1,61 @@
+// dense n x n assignment problems: DenseAssignment against SSP<long,long> on the bipartite graph with n*n arcs
+//
+// usage: assignment_benchmark [n ...]
+#include "../mcf_ssp.hxx"
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+using namespace MCF;
+
+template<typename F>
+double timed(F&& f)
+{
+  const auto begin = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<std::size_t> sizes = {100, 300, 1000, 2000};
+  if(argc > 1) {
+    sizes.clear();
+    for(int k=1; k<argc; ++k) { sizes.push_back(std::stoul(argv[k])); }
+  }
+
+  std::cout << std::setw(8) << "n" << std::setw(16) << "SSP build [s]" << std::setw(16) << "SSP solve [s]"
+    << std::setw(16) << "dense [s]" << std::setw(18) << "dense double [s]" << std::setw(10) << "speedup" << "\n";
+  for(const std::size_t n : sizes) {
+    std::mt19937 rng(n);
+    std::uniform_int_distribution<long> uni(0, 1000);
+    std::vector<long> cost(n*n);
+    for(auto& c : cost) { c = uni(rng); }
+
+    SSP<long,long> mcf(2*n, n*n);
+    const double ssp_build = timed([&]() {
+      for(std::size_t i=0; i<n; ++i) {
+        for(std::size_t j=0; j<n; ++j) { mcf.add_edge(i, n+j, 0, 1, cost[i*n+j]); }
+      }
+      for(std::size_t i=0; i<n; ++i) {
+        mcf.add_node_excess(i, 1);
+        mcf.add_node_excess(n+i, -1);
+      }
+      mcf.order();
+    });
+    long ssp_objective = 0;
+    const double ssp_solve = timed([&]() { ssp_objective = mcf.solve(); });
+
+    DenseAssignment<long> a(n, n, cost);
+    long dense_objective = 0;
+    const double dense = timed([&]() { dense_objective = a.solve(); });
+
+    DenseAssignment<double> b(n, n, std::vector<double>(cost.begin(), cost.end()));
+    double dense_double_objective = 0;
+    const double dense_double = timed([&]() { dense_double_objective = b.solve(); });
+
+    if(ssp_objective != dense_objective || double(ssp_objective) != dense_double_objective) { throw std::runtime_error("objectives disagree"); }
+    std::cout << std::setw(8) << n << std::setw(16) << ssp_build << std::setw(16) << ssp_solve
+      << std::setw(16) << dense << std::setw(18) << dense_double << std::setw(10) << (ssp_build + ssp_solve)/dense << "\n";
+  }
+}
@@ -0,0 +1,89 @@
+// throughput for many small assignment problems: a new solver per problem, one solver reused through reset(), and solve_batch().
+// Then the same problems in small batches, with threads created per batch by solve_batch() and kept alive by a BatchSolver
+#include "../mcf_ssp.hxx"
+#include <chrono>
+#include <random>
+
+using namespace MCF;
+
+int main(int argc, char** argv)
+{
+  const std::size_t no_problems = argc > 1 ? std::stoul(argv[1]) : 200000;
+  const std::size_t n = 3;
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<long> uni(0,10);
+  std::vector<BatchProblem<long,long>> problems(no_problems);
+  for(auto& p : problems) {
+    p.no_nodes = 2*n;
+    for(std::size_t i=0; i<n; ++i) {
+      for(std::size_t j=0; j<n; ++j) {
+        p.tails.push_back(i);
+        p.heads.push_back(n+j);
+        p.lower.push_back(0);
+        p.upper.push_back(1);
+        p.cost.push_back(uni(rng));
+      }
+    }
+    p.excess.assign(2*n, 0);
+    std::fill(p.excess.begin(), p.excess.begin()+n, 1);
+    std::fill(p.excess.begin()+n, p.excess.end(), -1);
+  }
+
+  auto fill = [](auto& mcf, const BatchProblem<long,long>& p) {
+    for(std::size_t e=0; e<p.tails.size(); ++e) { mcf.add_edge(p.tails[e], p.heads[e], p.lower[e], p.upper[e], p.cost[e]); }
+    for(std::size_t i=0; i<p.no_nodes; ++i) { mcf.add_node_excess(i, p.excess[i]); }
+  };
+
+  long checksum_new = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for(const auto& p : problems) {
+    SSP<long,long> mcf(p.no_nodes, p.tails.size());
+    fill(mcf, p);
+    checksum_new += mcf.solve();
+  }
+  const double new_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  long checksum_reset = 0;
+  begin = std::chrono::steady_clock::now();
+  SSP<long,long> mcf;
+  for(const auto& p : problems) {
+    mcf.reset(p.no_nodes, p.tails.size());
+    fill(mcf, p);
+    checksum_reset += mcf.solve();
+  }
+  const double reset_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  double batch_throughput = 0.0;
+  const auto solutions = solve_batch(problems, 0, &batch_throughput);
+  long checksum_batch = 0;
+  for(const auto& s : solutions) { checksum_batch += s.objective; }
+
+  const std::size_t batch_size = 100;
+  auto small_batches = [&](auto&& solve) {
+    long checksum = 0;
+    for(std::size_t first=0; first<problems.size(); first+=batch_size) {
+      const std::vector<BatchProblem<long,long>> batch(problems.begin()+first, problems.begin()+std::min(problems.size(), first+batch_size));
+      for(const auto& s : solve(batch)) { checksum += s.objective; }
+    }
+    return checksum;
+  };
+
+  begin = std::chrono::steady_clock::now();
+  const long checksum_small = small_batches([](const std::vector<BatchProblem<long,long>>& batch) { return solve_batch(batch); });
+  const double small_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  begin = std::chrono::steady_clock::now();
+  BatchSolver<long,long> pool;
+  const long checksum_pool = small_batches([&](const std::vector<BatchProblem<long,long>>& batch) { return pool.solve(batch); });
+  const double pool_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  if(checksum_new != checksum_reset || checksum_new != checksum_batch || checksum_new != checksum_small || checksum_new != checksum_pool) { throw std::runtime_error("objectives disagree"); }
+
+  std::cout << no_problems << " assignment problems of size " << n << "x" << n << ", " << std::thread::hardware_concurrency() << " hardware threads\n";
+  std::cout << "new solver per problem: " << no_problems/new_seconds << " problems/second\n";
+  std::cout << "reset():                " << no_problems/reset_seconds << " problems/second\n";
+  std::cout << "solve_batch():          " << batch_throughput << " problems/second\n";
+  std::cout << "batches of " << batch_size << ", solve_batch(): " << no_problems/small_seconds << " problems/second\n";
+  std::cout << "batches of " << batch_size << ", BatchSolver:   " << no_problems/pool_seconds << " problems/second\n";
+}
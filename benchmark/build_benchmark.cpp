@@ -0,0 +1,45 @@
+// graph construction: add_edge() per edge followed by order(), add_edges() followed by order(), and build()
+//
+// usage: build_benchmark [arcs] [threads]
+#include "../mcf_ssp.hxx"
+#include "generators.h"
+#include <chrono>
+
+using namespace MCF;
+
+template<typename F>
+double timed(F&& f)
+{
+  const auto begin = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t m = argc > 1 ? std::stoul(argv[1]) : 5000000;
+  const std::size_t no_threads = argc > 2 ? std::stoul(argv[2]) : 0;
+  const problem p = netgen_instance(std::max(std::size_t(16), m/10), m, std::max(std::size_t(1), m/200), std::max(std::size_t(1), m/200), 100*std::max(std::size_t(1), m/200), 1000, 100, 0);
+
+  SSP<long,long> single(p.no_nodes, p.tails.size());
+  const double add_edge_seconds = timed([&]() {
+    for(std::size_t e=0; e<p.tails.size(); ++e) { single.add_edge(p.tails[e], p.heads[e], p.lower[e], p.upper[e], p.cost[e]); }
+  });
+  const double add_edge_order_seconds = timed([&]() { single.order(no_threads); });
+
+  SSP<long,long> bulk(p.no_nodes, p.tails.size());
+  const double add_edges_seconds = timed([&]() { bulk.add_edges(p.tails, p.heads, p.lower, p.upper, p.cost); });
+  const double add_edges_order_seconds = timed([&]() { bulk.order(no_threads); });
+
+  SSP<long,long> built(p.no_nodes, p.tails.size());
+  const double build_seconds = timed([&]() { built.build(p.tails, p.heads, p.lower, p.upper, p.cost, no_threads); });
+
+  for(std::size_t a=0; a<built.no_arcs(); ++a) {
+    if(built.head(a) != single.head(a) || built.tail(a) != single.tail(a)) { throw std::runtime_error("arc layouts differ"); }
+  }
+
+  std::cout << p.no_nodes << " nodes, " << p.tails.size() << " arcs, " << std::thread::hardware_concurrency() << " hardware threads\n";
+  std::cout << "add_edge() + order():  " << add_edge_seconds << " + " << add_edge_order_seconds << " = " << add_edge_seconds + add_edge_order_seconds << " s\n";
+  std::cout << "add_edges() + order(): " << add_edges_seconds << " + " << add_edges_order_seconds << " = " << add_edges_seconds + add_edges_order_seconds << " s\n";
+  std::cout << "build():               " << build_seconds << " s\n";
+}
@@ -0,0 +1,87 @@
+// solve times of all algorithms on the gte instances and on generated networks with large capacities,
+// on which the number of augmentations of the successive shortest path algorithm grows with the flow value
+//
+// usage: cost_scaling_benchmark [--arcs m] [--no-gte]
+//   --arcs m       approximate number of arcs of every generated instance (default 200000)
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "generators.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+using namespace MCF;
+
+template<typename F>
+double timed(F&& f)
+{
+  const auto begin = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+SSP<long,long> build(const problem& p)
+{
+  SSP<long,long> mcf(p.no_nodes, p.tails.size());
+  mcf.add_edges(p.tails, p.heads, p.lower, p.upper, p.cost);
+  for(std::size_t i=0; i<p.no_nodes; ++i) {
+    if(p.excess[i] != 0) { mcf.add_node_excess(i, p.excess[i]); }
+  }
+  return mcf;
+}
+
+const std::vector<std::pair<std::string,Algorithm>> algorithms = {
+  {"ssp", Algorithm::successive_shortest_path},
+  {"ssp csr", Algorithm::successive_shortest_path_csr},
+  {"cap scaling", Algorithm::capacity_scaling},
+  {"primal dual", Algorithm::primal_dual},
+  {"cost scaling", Algorithm::cost_scaling}
+};
+
+// every algorithm solves its own copy of the ordered graph, objectives must agree
+void run(const std::string& instance, SSP<long,long> mcf)
+{
+  mcf.order();
+  std::cout << std::setw(24) << instance << std::setw(9) << mcf.no_nodes() << std::setw(9) << mcf.no_edges() << std::flush;
+  long objective = 0;
+  std::vector<double> seconds;
+  for(const auto& a : algorithms) {
+    SSP<long,long> f(mcf);
+    long o = 0;
+    seconds.push_back(timed([&]() { o = f.solve(a.second); }));
+    if(o != f.objective() || (seconds.size() > 1 && o != objective)) { throw std::runtime_error("objectives disagree on " + instance); }
+    objective = o;
+    std::cout << std::setw(18) << seconds.back() << std::flush;
+  }
+  std::cout << std::setw(10) << seconds.front()/seconds.back() << "\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t m = 200000;
+  bool gte_instances = true;
+  for(int k=1; k<argc; ++k) {
+    const std::string arg = argv[k];
+    if(arg == "--arcs" && k+1 < argc) { m = std::stoul(argv[++k]); }
+    else if(arg == "--no-gte") { gte_instances = false; }
+    else { std::cerr << "usage: " << argv[0] << " [--arcs m] [--no-gte]\n"; return 1; }
+  }
+
+  std::cout << std::setw(24) << "instance" << std::setw(9) << "nodes" << std::setw(9) << "arcs";
+  for(const auto& a : algorithms) { std::cout << std::setw(18) << a.first + " [s]"; }
+  std::cout << std::setw(10) << "speedup" << "\n";
+  std::cout << std::setprecision(4);
+
+  if(gte_instances) {
+    for(const auto& e : gte) {
+      run(e.file.substr(e.file.find_last_of('/')+1), load_dimacs_file<long,long>(e.file));
+    }
+  }
+
+  const std::size_t side = std::max(std::size_t(2), std::size_t(std::sqrt(m/4.0)));
+  const std::size_t terminals = std::max(std::size_t(1), m/200);
+  for(const long capacity : {100l, 10000l, 1000000l}) {
+    run("grid_cap" + std::to_string(capacity), build(grid_instance(side, side, std::max(std::size_t(1), side/4), 1000, capacity, 0)));
+    run("netgen_cap" + std::to_string(capacity), build(netgen_instance(std::max(std::size_t(16), m/10), m, terminals, terminals, capacity*terminals, 1000, capacity, 0)));
+  }
+}
@@ -0,0 +1,164 @@
+// random instance generators for benchmarking. All generators first plant a feasible flow and derive node excesses
+// from it, so every generated problem is feasible. Additional arcs without flow are added on top.
+#ifndef MCF_SSP_GENERATORS_H
+#define MCF_SSP_GENERATORS_H
+
+#include "../mcf_ssp.hxx"
+#include <random>
+
+typedef MCF::BatchProblem<long,long> problem;
+
+inline void add_arc(problem& p, const std::size_t i, const std::size_t j, const long upper, const long cost)
+{
+  p.tails.push_back(i);
+  p.heads.push_back(j);
+  p.lower.push_back(0);
+  p.upper.push_back(upper);
+  p.cost.push_back(cost);
+}
+
+// planted arc carrying the given flow, excesses of its endpoints are updated accordingly
+inline void add_flow_arc(problem& p, const std::size_t i, const std::size_t j, const long flow, const long cost)
+{
+  add_arc(p, i, j, flow, cost);
+  p.excess[i] += flow;
+  p.excess[j] -= flow;
+}
+
+// n x n assignment problem in which every person is connected to degree random jobs (all jobs if degree >= n).
+// Person i is always connected to job i.
+inline problem assignment_instance(const std::size_t n, std::size_t degree, const long max_cost, const unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::size_t> job(0, n-1);
+  std::uniform_int_distribution<long> cost(0, max_cost);
+  degree = std::min(degree, n);
+
+  problem p;
+  p.no_nodes = 2*n;
+  p.excess.assign(2*n, 0);
+  for(std::size_t i=0; i<n; ++i) {
+    add_flow_arc(p, i, n+i, 1, cost(rng));
+    for(std::size_t k=1; k<degree; ++k) {
+      const std::size_t j = degree == n ? (i+k)%n : job(rng);
+      if(j != i) { add_arc(p, i, n+j, 1, cost(rng)); }
+    }
+  }
+  return p;
+}
+
+// bipartite transportation problem with uncapacitated arcs. Each source ships to degree random sinks.
+inline problem transportation_instance(const std::size_t sources, const std::size_t sinks, const std::size_t degree, const long max_cost, const long max_supply, const unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::size_t> sink(0, sinks-1);
+  std::uniform_int_distribution<long> cost(0, max_cost);
+  std::uniform_int_distribution<long> supply(1, max_supply);
+
+  problem p;
+  p.no_nodes = sources + sinks;
+  p.excess.assign(sources + sinks, 0);
+  for(std::size_t i=0; i<sources; ++i) {
+    add_flow_arc(p, i, sources + sink(rng), supply(rng), cost(rng));
+    for(std::size_t k=1; k<degree; ++k) {
+      add_arc(p, i, sources + sink(rng), 0, cost(rng));
+    }
+  }
+  // arcs are uncapacitated
+  long total_supply = 0;
+  for(std::size_t i=0; i<sources; ++i) { total_supply += p.excess[i]; }
+  std::fill(p.upper.begin(), p.upper.end(), total_supply);
+  return p;
+}
+
+// width x height grid with arcs between neighbouring cells in both directions. Supply enters at random cells
+// of the left column and leaves at random cells of the right column along planted monotone paths.
+inline problem grid_instance(const std::size_t width, const std::size_t height, const std::size_t no_paths, const long max_cost, const long max_capacity, const unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::size_t> row(0, height-1);
+  std::uniform_int_distribution<long> cost(0, max_cost);
+  std::uniform_int_distribution<long> capacity(1, max_capacity);
+  auto node = [width](const std::size_t x, const std::size_t y) { return y*width + x; };
+
+  problem p;
+  p.no_nodes = width*height;
+  p.excess.assign(width*height, 0);
+  // arc ids of the four directions out of each cell
+  std::vector<std::size_t> right(width*height), left(width*height), down(width*height), up(width*height);
+  for(std::size_t y=0; y<height; ++y) {
+    for(std::size_t x=0; x<width; ++x) {
+      if(x+1 < width) {
+        right[node(x,y)] = p.tails.size(); add_arc(p, node(x,y), node(x+1,y), capacity(rng), cost(rng));
+        left[node(x+1,y)] = p.tails.size(); add_arc(p, node(x+1,y), node(x,y), capacity(rng), cost(rng));
+      }
+      if(y+1 < height) {
+        down[node(x,y)] = p.tails.size(); add_arc(p, node(x,y), node(x,y+1), capacity(rng), cost(rng));
+        up[node(x,y+1)] = p.tails.size(); add_arc(p, node(x,y+1), node(x,y), capacity(rng), cost(rng));
+      }
+    }
+  }
+  for(std::size_t k=0; k<no_paths; ++k) {
+    const long flow = capacity(rng);
+    std::size_t y = row(rng);
+    const std::size_t target = row(rng);
+    p.excess[node(0,y)] += flow;
+    p.excess[node(width-1,target)] -= flow;
+    for(std::size_t x=0; x<width; ++x) {
+      // move vertically towards the target row at a random column, otherwise to the right
+      while(y != target && (x+1 == width || rng()%2)) {
+        const std::size_t a = y < target ? down[node(x,y)] : up[node(x,y)];
+        p.upper[a] += flow;
+        y = y < target ? y+1 : y-1;
+      }
+      if(x+1 < width) { p.upper[right[node(x,y)]] += flow; }
+    }
+  }
+  return p;
+}
+
+// NETGEN-style network: supply is routed from sources over chains of random transshipment nodes to sinks.
+// Chain arcs get capacity of at least their flow, the remaining arcs connect random node pairs.
+inline problem netgen_instance(const std::size_t nodes, const std::size_t arcs, const std::size_t sources, const std::size_t sinks,
+    const long total_supply, const long max_cost, const long max_capacity, const unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<std::size_t> sink(nodes-sinks, nodes-1);
+  std::uniform_int_distribution<std::size_t> transshipment(sources, nodes-sinks-1);
+  std::uniform_int_distribution<std::size_t> any_node(0, nodes-1);
+  std::uniform_int_distribution<std::size_t> chain_length(1, 8);
+  std::uniform_int_distribution<long> cost(0, max_cost);
+  std::uniform_int_distribution<long> capacity(1, max_capacity);
+
+  problem p;
+  p.no_nodes = nodes;
+  p.excess.assign(nodes, 0);
+  std::vector<long> supply(sources, total_supply/sources);
+  supply[0] += total_supply%sources;
+  for(std::size_t s=0; s<sources; ++s) {
+    // split supply of every source over a few chains
+    long left = supply[s];
+    while(left > 0 && p.tails.size() < arcs) {
+      const long flow = std::min(left, capacity(rng));
+      left -= flow;
+      std::size_t i = s;
+      for(std::size_t k=chain_length(rng); k>0; --k) {
+        const std::size_t j = transshipment(rng);
+        if(j == i) continue;
+        add_flow_arc(p, i, j, flow, cost(rng));
+        p.upper.back() += capacity(rng);
+        i = j;
+      }
+      add_flow_arc(p, i, sink(rng), flow, cost(rng));
+      p.upper.back() += capacity(rng);
+    }
+  }
+  while(p.tails.size() < arcs) {
+    const std::size_t i = any_node(rng);
+    const std::size_t j = any_node(rng);
+    if(i != j) { add_arc(p, i, j, capacity(rng), cost(rng)); }
+  }
+  return p;
+}
+
+#endif // MCF_SSP_GENERATORS_H
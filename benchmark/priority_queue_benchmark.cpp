@@ -0,0 +1,44 @@
+// compare priority queues used in SSP::Dijkstra on the gte instances
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include <chrono>
+#include <iomanip>
+
+using namespace MCF;
+
+template<typename CostType, template<typename,typename> class PriorityQueue>
+double solve_time(const std::string& filename, const std::size_t repetitions, const bool csr)
+{
+  std::unique_ptr<SSP<int,CostType,PriorityQueue>> f(read_dimacs_file<int,CostType,PriorityQueue>(filename));
+  double seconds = 0.0;
+  for(std::size_t r=0; r<repetitions; ++r) {
+    SSP<int,CostType,PriorityQueue> g(*f);
+    const auto begin = std::chrono::steady_clock::now();
+    const CostType objective = csr ? g.solve_csr() : g.solve();
+    const auto end = std::chrono::steady_clock::now();
+    seconds += std::chrono::duration<double>(end - begin).count();
+    if(objective != g.objective()) { throw std::runtime_error("inconsistent objective for " + filename); }
+  }
+  return seconds;
+}
+
+template<typename CostType, template<typename,typename> class PriorityQueue>
+void run(const std::string& name, const std::size_t repetitions)
+{
+  for(const bool csr : {false, true}) {
+    double total = 0.0;
+    for(auto e : gte) { total += solve_time<CostType,PriorityQueue>(e.file, repetitions, csr); }
+    std::cout << std::setw(28) << std::left << name << std::setw(12) << (csr ? "solve_csr" : "solve")
+      << 1000.0*total/repetitions << " ms per pass over gte\n";
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t repetitions = argc > 1 ? std::stoul(argv[1]) : 100;
+  run<long,BinaryHeap>("long, BinaryHeap", repetitions);
+  run<long,QuaternaryHeap>("long, QuaternaryHeap", repetitions);
+  run<long,RadixHeap>("long, RadixHeap", repetitions);
+  run<double,BinaryHeap>("double, BinaryHeap", repetitions);
+  run<double,QuaternaryHeap>("double, QuaternaryHeap", repetitions);
+}
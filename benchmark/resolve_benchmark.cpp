@@ -0,0 +1,79 @@
+// compare warm started resolve() after small batches of changes with a cold solve() of the changed problem
+#include "../mcf_ssp.hxx"
+#include <chrono>
+#include <random>
+
+using namespace MCF;
+
+struct edge { std::size_t i, j; long upper, cost; };
+
+SSP<long,long> build(const std::size_t no_nodes, const std::vector<edge>& edges, const std::vector<long>& excess)
+{
+  SSP<long,long> mcf(no_nodes, edges.size());
+  for(const auto& e : edges) { mcf.add_edge(e.i, e.j, 0, e.upper, e.cost); }
+  for(std::size_t i=0; i<no_nodes; ++i) { mcf.add_node_excess(i, excess[i]); }
+  return mcf;
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t no_sources = argc > 1 ? std::stoul(argv[1]) : 2000;
+  const std::size_t degree = 20;
+  const std::size_t batch_size = 10;
+  const std::size_t iterations = 20;
+
+  // sparse transportation problem. Source i is always connected to sink i by an expensive arc of large capacity.
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<std::size_t> sink(0, no_sources-1);
+  std::uniform_int_distribution<long> capacity(1, 100);
+  std::uniform_int_distribution<long> cost(0, 1000);
+  std::vector<edge> edges;
+  std::vector<long> excess(2*no_sources, 0);
+  for(std::size_t i=0; i<no_sources; ++i) {
+    edges.push_back({i, no_sources+i, 1000, 100000});
+    for(std::size_t k=0; k<degree; ++k) {
+      edges.push_back({i, no_sources+sink(rng), capacity(rng), cost(rng)});
+    }
+    const long b = capacity(rng);
+    excess[i] += b;
+    excess[no_sources + (i+1)%no_sources] -= b;
+  }
+
+  SSP<long,long> warm = build(2*no_sources, edges, excess);
+  warm.solve();
+
+  std::uniform_int_distribution<std::size_t> random_edge(0, edges.size()-1);
+  std::uniform_int_distribution<long> cost_delta(-100, 100);
+  std::uniform_int_distribution<long> capacity_delta(-10, 10);
+  double warm_seconds = 0.0, cold_seconds = 0.0;
+  for(std::size_t it=0; it<iterations; ++it) {
+    for(std::size_t b=0; b<batch_size; ++b) {
+      const std::size_t e = random_edge(rng);
+      const long delta = std::max(cost_delta(rng), -edges[e].cost);
+      edges[e].cost += delta;
+      warm.update_cost(2*e, delta);
+    }
+    for(std::size_t b=0; b<batch_size; ++b) {
+      const std::size_t e = random_edge(rng);
+      // keep upper >= 1, the cold rebuild passes it to add_edge, which requires lower < upper
+      const long delta = std::max(capacity_delta(rng), 1 - edges[e].upper);
+      edges[e].upper += delta;
+      warm.update_capacity(2*e, delta);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    const long warm_objective = warm.resolve();
+    warm_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    SSP<long,long> cold = build(2*no_sources, edges, excess);
+    begin = std::chrono::steady_clock::now();
+    const long cold_objective = cold.solve();
+    cold_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if(warm_objective != cold_objective) { throw std::runtime_error("resolve() and solve() disagree"); }
+  }
+
+  std::cout << "nodes = " << 2*no_sources << ", edges = " << edges.size() << ", " << batch_size << " cost and " << batch_size << " capacity changes per iteration\n";
+  std::cout << "resolve(): " << 1000.0*warm_seconds/iterations << " ms per iteration\n";
+  std::cout << "solve():   " << 1000.0*cold_seconds/iterations << " ms per iteration\n";
+}
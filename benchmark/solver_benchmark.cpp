@@ -0,0 +1,139 @@
+// time the phases of the solver on the gte instances and on generated networks. Results are written as CSV or JSON.
+//
+// usage: solver_benchmark [--format csv|json] [--repetitions k] [--arcs m] [--no-gte] [--no-generated]
+//   --arcs m       approximate number of arcs of every generated instance (default 50000)
+//   --repetitions  every instance is loaded and solved k times, the minimum time of every phase is reported
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "generators.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+using namespace MCF;
+
+struct result
+{
+  std::string instance;
+  std::string family;
+  std::size_t nodes = 0, arcs = 0;
+  long objective = 0;
+  // seconds per phase, minimum over repetitions
+  double load = std::numeric_limits<double>::max();
+  double order = std::numeric_limits<double>::max();
+  double init = std::numeric_limits<double>::max();
+  double solve = std::numeric_limits<double>::max();
+};
+
+template<typename F>
+double timed(F&& f)
+{
+  const auto begin = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// load builds the solver, for files this includes parsing
+template<typename LOAD>
+result run(const std::string& instance, const std::string& family, LOAD&& load, const std::size_t repetitions)
+{
+  result r;
+  r.instance = instance;
+  r.family = family;
+  for(std::size_t k=0; k<repetitions; ++k) {
+    SSP<long,long> mcf;
+    r.load = std::min(r.load, timed([&]() { mcf = load(); }));
+    r.order = std::min(r.order, timed([&]() { mcf.order(); }));
+    r.init = std::min(r.init, timed([&]() { mcf.init(); }));
+    long objective = 0;
+    r.solve = std::min(r.solve, timed([&]() { objective = mcf.resolve(); }));
+    if(objective != mcf.objective()) { throw std::runtime_error("inconsistent objective for " + instance); }
+    if(k > 0 && objective != r.objective) { throw std::runtime_error("objective differs between repetitions for " + instance); }
+    r.objective = objective;
+    r.nodes = mcf.no_nodes();
+    r.arcs = mcf.no_edges();
+  }
+  return r;
+}
+
+SSP<long,long> build(const problem& p)
+{
+  SSP<long,long> mcf(p.no_nodes, p.tails.size());
+  mcf.add_edges(p.tails, p.heads, p.lower, p.upper, p.cost);
+  for(std::size_t i=0; i<p.no_nodes; ++i) {
+    if(p.excess[i] != 0) { mcf.add_node_excess(i, p.excess[i]); }
+  }
+  return mcf;
+}
+
+void write_csv(std::ostream& s, const std::vector<result>& results)
+{
+  s << "instance,family,nodes,arcs,objective,load_s,order_s,init_s,solve_s,total_s\n";
+  s << std::setprecision(6);
+  for(const auto& r : results) {
+    s << r.instance << "," << r.family << "," << r.nodes << "," << r.arcs << "," << r.objective << ","
+      << r.load << "," << r.order << "," << r.init << "," << r.solve << "," << r.load + r.order + r.init + r.solve << "\n";
+  }
+}
+
+void write_json(std::ostream& s, const std::vector<result>& results)
+{
+  s << std::setprecision(6) << "[\n";
+  for(std::size_t k=0; k<results.size(); ++k) {
+    const auto& r = results[k];
+    s << "  {\"instance\": \"" << r.instance << "\", \"family\": \"" << r.family << "\", \"nodes\": " << r.nodes << ", \"arcs\": " << r.arcs
+      << ", \"objective\": " << r.objective << ", \"load_s\": " << r.load << ", \"order_s\": " << r.order
+      << ", \"init_s\": " << r.init << ", \"solve_s\": " << r.solve << ", \"total_s\": " << r.load + r.order + r.init + r.solve << "}"
+      << (k+1 < results.size() ? ",\n" : "\n");
+  }
+  s << "]\n";
+}
+
+int main(int argc, char** argv)
+{
+  std::string format = "csv";
+  std::size_t repetitions = 3;
+  std::size_t m = 50000;
+  bool gte_instances = true;
+  bool generated_instances = true;
+  for(int k=1; k<argc; ++k) {
+    const std::string arg = argv[k];
+    if(arg == "--format" && k+1 < argc) { format = argv[++k]; }
+    else if(arg == "--repetitions" && k+1 < argc) { repetitions = std::stoul(argv[++k]); }
+    else if(arg == "--arcs" && k+1 < argc) { m = std::stoul(argv[++k]); }
+    else if(arg == "--no-gte") { gte_instances = false; }
+    else if(arg == "--no-generated") { generated_instances = false; }
+    else {
+      std::cerr << "usage: " << argv[0] << " [--format csv|json] [--repetitions k] [--arcs m] [--no-gte] [--no-generated]\n";
+      return 1;
+    }
+  }
+  if(format != "csv" && format != "json") { std::cerr << "unknown format " << format << "\n"; return 1; }
+  repetitions = std::max(std::size_t(1), repetitions);
+
+  std::vector<result> results;
+  if(gte_instances) {
+    for(const auto& e : gte) {
+      const std::string name = e.file.substr(e.file.find_last_of('/')+1);
+      results.push_back(run(name, "gte", [&]() { return load_dimacs_file<long,long>(e.file); }, repetitions));
+      if(results.back().objective != e.objective) { throw std::runtime_error("wrong objective for " + name); }
+    }
+  }
+  if(generated_instances) {
+    const std::size_t degree = 10;
+    const std::size_t side = std::max(std::size_t(2), std::size_t(std::sqrt(double(m)/4)));
+    const std::vector<std::pair<std::string,problem>> instances = {
+      {"assignment_" + std::to_string(m), assignment_instance(std::max(std::size_t(2), m/degree), degree, 1000, 0)},
+      {"transportation_" + std::to_string(m), transportation_instance(std::max(std::size_t(1), m/degree), std::max(std::size_t(1), m/degree), degree, 1000, 100, 0)},
+      {"grid_" + std::to_string(m), grid_instance(side, side, std::max(std::size_t(1), side/4), 1000, 100, 0)},
+      {"netgen_" + std::to_string(m), netgen_instance(std::max(std::size_t(16), m/10), m, std::max(std::size_t(1), m/200), std::max(std::size_t(1), m/200), 100*std::max(std::size_t(1), m/200), 1000, 100, 0)}
+    };
+    for(const auto& i : instances) {
+      const std::string family = i.first.substr(0, i.first.find('_'));
+      results.push_back(run(i.first, family, [&]() { return build(i.second); }, repetitions));
+    }
+  }
+
+  if(format == "csv") { write_csv(std::cout, results); }
+  else { write_json(std::cout, results); }
+}
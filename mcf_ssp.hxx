@@ -3,10 +3,13 @@
 
 #include <cmath>
 #include <cstring>
+#include <cstdint>
+#include <cstdlib>
 #include <assert.h>
 
 #include <algorithm>
 #include <numeric>
+#include <limits>
 #include <memory>
 #include <string>
 
@@ -15,11 +18,416 @@
 #include <sstream>
 
 #include <vector>
+#include <array>
+#include <deque>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <iterator>
+#include <tuple>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 
 namespace MCF {
 
-    template <typename FlowType, typename CostType> class SSP
+    // call f(0),...,f(no_threads-1) in parallel, f(0) in the calling thread. Shares whose thread cannot be started
+    // run in the calling thread as well. All threads are joined before an exception thrown by f is rethrown,
+    // the one of the lowest numbered share if several fail.
+    template <typename F>
+        void run_parallel(const std::size_t no_threads, F&& f)
+        {
+            std::vector<std::exception_ptr> errors(no_threads);
+            auto run = [&f,&errors](const std::size_t t) {
+                try { f(t); } catch(...) { errors[t] = std::current_exception(); }
+            };
+            std::vector<std::thread> threads;
+            std::size_t t = 1;
+            try {
+                threads.reserve(no_threads);
+                for(; t<no_threads; ++t) { threads.emplace_back(run, t); }
+            } catch(...) {}
+            run(0);
+            for(; t<no_threads; ++t) { run(t); }
+            for(auto& th : threads) { th.join(); }
+            for(auto& e : errors) {
+                if(e) { std::rethrow_exception(e); }
+            }
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    // Priority queues used by SSP::Dijkstra.
+    // A queue is instantiated as PriorityQueue<Node, Key>, where Node has an unsigned integral member heap_ptr
+    // the queue may use freely while the node is contained in it. heap_ptr may be as narrow as the index type of SSP,
+    // so the values stored there must be smaller than the number of nodes in the queue.
+    /////////////////////////////////////////////////////////////////////////
+
+    // binary heap, default
+    template <typename Node, typename Key> class BinaryHeap
+    {
+        public:
+            BinaryHeap();
+            BinaryHeap(const BinaryHeap&) = delete;
+            BinaryHeap& operator=(const BinaryHeap&) = delete;
+            ~BinaryHeap();
+            void Reset();
+            Key GetKey(Node* i);
+            void Add(Node* i, Key key);
+            void DecreaseKey(Node* i, Key key);
+            Node* RemoveMin(Key& key);
+
+        private:
+            struct Item
+            {
+                Node*	i;
+                Key		key;
+            }* array;
+            std::size_t N, arraySize;
+            void Swap(std::size_t k1, std::size_t k2);
+    };
+
+    // 4-ary heap with keys and nodes stored in separate arrays. Sifting moves a hole instead of swapping items.
+    template <typename Node, typename Key> class QuaternaryHeap
+    {
+        public:
+            void Reset() { keys.clear(); items.clear(); }
+            Key GetKey(Node* i) { return keys[i->heap_ptr]; }
+            void Add(Node* i, Key key);
+            void DecreaseKey(Node* i, Key key);
+            Node* RemoveMin(Key& key);
+
+        private:
+            std::vector<Key> keys;
+            std::vector<Node*> items;
+            void SiftUp(std::size_t k, Node* i, Key key);
+    };
+
+    // radix heap for integral keys. Requires the monotonicity property of Dijkstra's algorithm:
+    // keys that are added or decreased are never smaller than the last key removed.
+    template <typename Node, typename Key> class RadixHeap
+    {
+        static_assert(std::is_integral<Key>::value, "RadixHeap requires integral keys");
+
+        public:
+            RadixHeap() : last(0), N(0) {}
+            void Reset();
+            Key GetKey(Node* i) { return buckets[location[i->heap_ptr] & bucket_mask][location[i->heap_ptr] >> bucket_bits].key; }
+            void Add(Node* i, Key key);
+            void DecreaseKey(Node* i, Key key);
+            Node* RemoveMin(Key& key);
+
+        private:
+            struct Item
+            {
+                Node*	i;
+                Key		key;
+            };
+            // bucket and position do not fit into a narrow heap_ptr, so heap_ptr is a handle into location instead.
+            // location stores the bucket in the lower bits and the position inside the bucket in the upper ones.
+            static constexpr std::size_t bucket_bits = 7;
+            static constexpr std::size_t bucket_mask = (std::size_t(1) << bucket_bits) - 1;
+            static constexpr std::size_t no_buckets = 8*sizeof(Key) + 1;
+            std::array<std::vector<Item>, no_buckets> buckets;
+            std::vector<std::size_t> location;
+            std::vector<std::size_t> freeHandles; // handles of removed nodes, reused by Add
+            Key last;
+            std::size_t N;
+
+            std::size_t Bucket(Key key) const;
+            void Insert(Node* i, Key key);
+            void Erase(Node* i);
+    };
+
+    template <typename Node, typename Key> 
+        inline BinaryHeap<Node, Key>::BinaryHeap()
+        {
+            N = 0;
+            arraySize = 16;
+            array = (Item*) malloc(arraySize*sizeof(Item));
+            if(!array) { throw std::bad_alloc(); }
+        }
+
+    template <typename Node, typename Key> 
+        inline BinaryHeap<Node, Key>::~BinaryHeap()
+        {
+            if(array)
+                free(array);
+        }
+
+    template <typename Node, typename Key> 
+        inline void BinaryHeap<Node, Key>::Reset()
+        {
+            N = 0;
+        }
+
+    template <typename Node, typename Key> 
+        inline Key BinaryHeap<Node, Key>::GetKey(Node* i)
+        {
+            return array[i->heap_ptr].key;
+        }
+
+    template <typename Node, typename Key> 
+        inline void BinaryHeap<Node, Key>::Swap(std::size_t k1, std::size_t k2)
+        {
+            Item* a = array+k1;
+            Item* b = array+k2;
+            a->i->heap_ptr = k2;
+            b->i->heap_ptr = k1;
+            Node* i = a->i;   a->i   = b->i;   b->i   = i;
+            Key key = a->key; a->key = b->key; b->key = key;
+        }
+
+    template <typename Node, typename Key> 
+        inline void BinaryHeap<Node, Key>::Add(Node* i, Key key)
+        {
+            if (N == arraySize)
+            {
+                arraySize *= 2;
+                Item* new_array = (Item*) realloc(array, arraySize*sizeof(Item));
+                if(!new_array) { throw std::bad_alloc(); }
+                array = new_array;
+            }
+            std::size_t k = i->heap_ptr = N ++;
+            array[k].i = i;
+            array[k].key = key;
+            while (k > 0)
+            {
+                std::size_t k2 = (k-1)/2;
+                if (array[k2].key <= array[k].key) break;
+                Swap(k, k2);
+                k = k2;
+            }
+        }
+
+    template <typename Node, typename Key> 
+        inline void BinaryHeap<Node, Key>::DecreaseKey(Node* i, Key key)
+        {
+            std::size_t k = i->heap_ptr;
+            array[k].key = key;
+            while (k > 0)
+            {
+                std::size_t k2 = (k-1)/2;
+                if (array[k2].key <= array[k].key) break;
+                Swap(k, k2);
+                k = k2;
+            }
+        }
+
+    template <typename Node, typename Key> 
+        inline Node* BinaryHeap<Node, Key>::RemoveMin(Key& key)
+        {
+            if (N == 0) return nullptr;
+
+            Swap(0, N-1);
+            N --;
+
+            std::size_t k = 0;
+            while ( 1 )
+            {
+                std::size_t k1 = 2*k + 1, k2 = k1 + 1;
+                if (k1 >= N) break;
+                std::size_t k_min = (k2 >= N || array[k1].key <= array[k2].key) ? k1 : k2;
+                if (array[k].key <= array[k_min].key) break;
+                Swap(k, k_min);
+                k = k_min;
+            }
+
+            key = array[N].key;
+            return array[N].i;
+        }
+
+    template <typename Node, typename Key> 
+        inline void QuaternaryHeap<Node, Key>::SiftUp(std::size_t k, Node* i, Key key)
+        {
+            while (k > 0)
+            {
+                const std::size_t k2 = (k-1)/4;
+                if (keys[k2] <= key) break;
+                keys[k] = keys[k2];
+                items[k] = items[k2];
+                items[k]->heap_ptr = k;
+                k = k2;
+            }
+            keys[k] = key;
+            items[k] = i;
+            i->heap_ptr = k;
+        }
+
+    template <typename Node, typename Key> 
+        inline void QuaternaryHeap<Node, Key>::Add(Node* i, Key key)
+        {
+            keys.push_back(key);
+            items.push_back(i);
+            SiftUp(keys.size()-1, i, key);
+        }
+
+    template <typename Node, typename Key> 
+        inline void QuaternaryHeap<Node, Key>::DecreaseKey(Node* i, Key key)
+        {
+            assert(key <= keys[i->heap_ptr]);
+            SiftUp(i->heap_ptr, i, key);
+        }
+
+    template <typename Node, typename Key> 
+        inline Node* QuaternaryHeap<Node, Key>::RemoveMin(Key& key)
+        {
+            if (keys.empty()) return nullptr;
+
+            Node* min = items[0];
+            key = keys[0];
+
+            const Key last_key = keys.back();
+            Node* last = items.back();
+            keys.pop_back();
+            items.pop_back();
+            const std::size_t N = keys.size();
+            if (N == 0) return min;
+
+            // move the hole at the root downwards until last fits in
+            std::size_t k = 0;
+            while ( 1 )
+            {
+                const std::size_t c = 4*k + 1;
+                if (c >= N) break;
+                const std::size_t c_end = std::min(c+4, N);
+                std::size_t k_min = c;
+                for (std::size_t c2=c+1; c2<c_end; ++c2)
+                {
+                    if (keys[c2] < keys[k_min]) k_min = c2;
+                }
+                if (last_key <= keys[k_min]) break;
+                keys[k] = keys[k_min];
+                items[k] = items[k_min];
+                items[k]->heap_ptr = k;
+                k = k_min;
+            }
+            keys[k] = last_key;
+            items[k] = last;
+            last->heap_ptr = k;
+
+            return min;
+        }
+
+    template <typename Node, typename Key> 
+        inline void RadixHeap<Node, Key>::Reset()
+        {
+            for (auto& b : buckets) b.clear();
+            location.clear();
+            freeHandles.clear();
+            last = 0;
+            N = 0;
+        }
+
+    template <typename Node, typename Key> 
+        inline std::size_t RadixHeap<Node, Key>::Bucket(Key key) const
+        {
+            assert(key >= last);
+            unsigned long long x = static_cast<unsigned long long>(key) ^ static_cast<unsigned long long>(last);
+            // index of the highest differing bit plus one
+#if defined(__GNUC__)
+            return x == 0 ? 0 : 8*sizeof(unsigned long long) - __builtin_clzll(x);
+#else
+            std::size_t b = 0;
+            while (x) { ++b; x >>= 1; }
+            return b;
+#endif
+        }
+
+    template <typename Node, typename Key> 
+        inline void RadixHeap<Node, Key>::Insert(Node* i, Key key)
+        {
+            const std::size_t b = Bucket(key);
+            location[i->heap_ptr] = (buckets[b].size() << bucket_bits) | b;
+            buckets[b].push_back({i, key});
+        }
+
+    template <typename Node, typename Key> 
+        inline void RadixHeap<Node, Key>::Erase(Node* i)
+        {
+            const std::size_t l = location[i->heap_ptr];
+            auto& bucket = buckets[l & bucket_mask];
+            const std::size_t k = l >> bucket_bits;
+            bucket[k] = bucket.back();
+            location[bucket[k].i->heap_ptr] = l;
+            bucket.pop_back();
+        }
+
+    template <typename Node, typename Key> 
+        inline void RadixHeap<Node, Key>::Add(Node* i, Key key)
+        {
+            assert(key >= 0);
+            if (freeHandles.empty())
+            {
+                i->heap_ptr = location.size();
+                location.push_back(0);
+            }
+            else
+            {
+                i->heap_ptr = freeHandles.back();
+                freeHandles.pop_back();
+            }
+            Insert(i, key);
+            ++N;
+        }
+
+    template <typename Node, typename Key> 
+        inline void RadixHeap<Node, Key>::DecreaseKey(Node* i, Key key)
+        {
+            assert(key <= GetKey(i));
+            Erase(i);
+            Insert(i, key);
+        }
+
+    template <typename Node, typename Key> 
+        inline Node* RadixHeap<Node, Key>::RemoveMin(Key& key)
+        {
+            if (N == 0) return nullptr;
+
+            if (buckets[0].empty())
+            {
+                // redistribute the first non-empty bucket relative to its minimum. All items land in lower buckets.
+                std::size_t b = 1;
+                while (buckets[b].empty()) ++b;
+                auto& bucket = buckets[b];
+                last = std::min_element(bucket.begin(), bucket.end(), [](const Item& x, const Item& y) { return x.key < y.key; })->key;
+                for (const Item& it : bucket) Insert(it.i, it.key);
+                bucket.clear();
+            }
+
+            const Item it = buckets[0].back();
+            buckets[0].pop_back();
+            freeHandles.push_back(it.i->heap_ptr);
+            --N;
+            key = it.key;
+            return it.i;
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    // Define SSP_STATISTICS before including this file to collect solver statistics (see SSP::statistics()).
+    // Otherwise the instrumentation is compiled out and the counters stay zero.
+#ifdef SSP_STATISTICS
+#define SSP_STAT(...) __VA_ARGS__
+#else
+#define SSP_STAT(...)
+#endif
+
+    /////////////////////////////////////////////////////////////////////////
+
+    // algorithms selectable through SSP::solve(Algorithm), all of them work on the same graph
+    enum class Algorithm { successive_shortest_path, successive_shortest_path_csr, capacity_scaling, primal_dual, cost_scaling };
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue = BinaryHeap, typename IndexType = std::uint32_t> class SSP
     {
         public:
             typedef std::size_t NodeId;
@@ -32,8 +440,8 @@ namespace MCF {
             SSP& operator=(SSP& o);
             SSP& operator=(SSP&& o);
 
-            template<typename _FlowType, typename _CostType>
-                friend void swap(SSP<_FlowType,_CostType>&,SSP<_FlowType,_CostType>&);
+            template<typename _FlowType, typename _CostType, template<typename,typename> class _PriorityQueue, typename _IndexType>
+                friend void swap(SSP<_FlowType,_CostType,_PriorityQueue,_IndexType>&,SSP<_FlowType,_CostType,_PriorityQueue,_IndexType>&);
 
             void copy_node(const SSP& o, NodeId i);
             void copy_arc(const SSP& o, EdgeId i);
@@ -41,6 +449,11 @@ namespace MCF {
             // Destructor
             ~SSP();
 
+            // remove all arcs and excesses and set the number of nodes to NodeNum, keeping allocated buffers.
+            // Memory is only reallocated if NodeNum or edgeNumMax exceed what has been allocated before.
+            void reset(std::size_t NodeNum, std::size_t edgeNumMax);
+            void clear() { reset(nodeNum, edgeNumMax); }
+
             void add_node_excess(NodeId i, FlowType excess);
 
             // first call returns 0, second 1, and so on.
@@ -48,8 +461,45 @@ namespace MCF {
             // cost can be negative.
             // EdgeIds only stay unchanged when arcs are not reordered
             EdgeId add_edge(NodeId i, NodeId j, FlowType lower, FlowType upper, CostType cost);
+            // add edges tails[k] -> heads[k] in bulk, with the same conventions as add_edge. EdgeIds are assigned consecutively.
+            // Arc lists are linked in one pass afterwards instead of one insertion per arc.
+            void add_edges(const std::vector<NodeId>& tails, const std::vector<NodeId>& heads,
+                    const std::vector<FlowType>& lower, const std::vector<FlowType>& upper, const std::vector<CostType>& cost);
+            // bulk construction of an empty graph. Arcs are placed directly in the layout of order(), hence edge e is at arc edge_arc(e).
+            // Placement is computed by a counting sort, in parallel with no_threads threads for large inputs (0: choose automatically).
+            void build(const std::vector<NodeId>& tails, const std::vector<NodeId>& heads,
+                    const std::vector<FlowType>& lower, const std::vector<FlowType>& upper, const std::vector<CostType>& cost,
+                    std::size_t no_threads = 0);
 
             CostType solve();
+            // same as solve(), but the shortest path computations run on a frozen forward-star (CSR) copy of the arcs.
+            // Saturated arcs are skipped instead of being moved between lists. Results are written back afterwards.
+            CostType solve_csr();
+            // capacity scaling variant of solve(): in phase Delta only amounts of at least Delta are sent along arcs with r_cap >= Delta.
+            // Needs O(m log U) shortest path computations, where U is the largest excess.
+            CostType solve_capacity_scaling();
+            // primal-dual variant of solve() for problems with many sources and sinks. Each phase runs one Dijkstra from all
+            // nodes with positive excess, updates all potentials and then augments along admissible (zero reduced cost) arcs
+            // by a depth first search until the admissible network is blocked.
+            // Throws std::runtime_error if the excesses cannot be balanced, the flow is then not meaningful.
+            CostType solve_primal_dual();
+            // cost scaling push-relabel (Goldberg). Costs are multiplied by the smallest power of two above no_nodes() and epsilon
+            // is divided by alpha in every refine phase, which pushes flow along arcs of negative reduced cost and relabels nodes
+            // in FIFO order on a frozen forward-star (CSR) copy of the arcs. The number of phases depends on the costs only, not
+            // on capacities or excesses, hence it suits networks with large flow values. The first phase starts from the largest
+            // cost. Only if no node has excess, the current flow is kept and the first phase starts from its largest violation
+            // of optimality, which is none for an optimal flow. update_cost() usually creates excesses, so this is no warm start.
+            // For integer costs the result is optimal with exact potentials, floating point costs are finished by solve().
+            // Scaled costs times no_nodes() must fit into CostType.
+            CostType solve_cost_scaling(CostType alpha = 16);
+            CostType solve(Algorithm algorithm);
+            // warm started re-solve after changes through update_cost, update_capacity and add_node_excess.
+            // These functions repair optimality of the changed arcs on the spot, hence only nodes that became
+            // imbalanced are processed, starting from the current flow and potentials.
+            CostType resolve();
+            // first phase of solve(): saturate arcs with negative reduced cost and collect nodes with positive excess.
+            // solve() is equivalent to init() followed by resolve(), which allows to time both phases separately.
+            void init() { Init(); }
             CostType objective() const;
 
             ///////////////////////////////////////////////////
@@ -60,31 +510,82 @@ namespace MCF {
             void SetReverseRCap(EdgeId e, FlowType new_rcap);
             void PushFlow(EdgeId e, FlowType delta);
             void update_cost(EdgeId e, CostType delta);
+            // increase residual capacity of arc e by delta. If delta is negative and exceeds the residual capacity,
+            // flow on e is reduced, leaving excesses at its endpoints to be routed by resolve().
+            void update_capacity(EdgeId e, FlowType delta);
             void reset_costs();
 
             // query functions 
-            void order() { order_inter_nodes(); order_intra_nodes(); } // reorder arcs so that outgoing ones from given node are ordered consecutively
+            // reorder arcs so that outgoing ones from each node are consecutive and sorted by head node.
+            // Arcs are counting sorted into fresh buffers, in parallel for large graphs. Use edge_arc() to find the arc of an edge afterwards.
+            void order(std::size_t no_threads = 0);
+            // arc of the e-th added edge, its reverse arc is at arcs sister. Equals 2*e as long as arcs have not been reordered.
+            EdgeId edge_arc(const EdgeId e) const { assert(e < edgeNum); return e < edgeArc.size() ? edgeArc[e] : 2*e; }
             NodeId no_nodes() const;
             EdgeId no_edges() const;
             EdgeId no_arcs() const;
             FlowType flow(const NodeId i, const EdgeId e) const; // get the flow of the e-th edge outgoing out of i
             FlowType flow(const EdgeId e) const; // get the flow of the e-th edge outgoing out of i
-            CostType cost(const EdgeId e) const { assert(e >= 0 && e < 2*edgeNum); return arcs[e].cost; }
-            CostType reduced_cost(const EdgeId e) const { assert(e >= 0 && e < 2*edgeNum); return arcs[e].GetRCost(); }
-            CostType residual_capacity(const EdgeId e) const { assert(e >= 0 && e < 2*edgeNum); return arcs[e].r_cap; }
-            NodeId tail(EdgeId e) const { return arcs[e].sister->head - nodes; }
-            NodeId head(EdgeId e) const { return arcs[e].head - nodes; }
+            CostType cost(const EdgeId e) const { assert(e < 2*edgeNum); return arcs[e].cost; }
+            CostType reduced_cost(const EdgeId e) const { assert(e < 2*edgeNum); return GetRCost(&arcs[e]); }
+            CostType residual_capacity(const EdgeId e) const { assert(e < 2*edgeNum); return arcs[e].r_cap; }
+            NodeId tail(EdgeId e) const { return arcs[arcs[e].sister].head; }
+            NodeId head(EdgeId e) const { return arcs[e].head; }
             EdgeId first_outgoing_arc(NodeId i) const;
             std::size_t no_outgoing_arcs(NodeId i) const;
             FlowType upper_bound(EdgeId i) const { assert(arc_valid(&arcs[i])); return capacity[i]; }
-            FlowType lower_bound(EdgeId i) const { assert(arc_valid(&arcs[i])); const EdgeId s = arcs[i].sister - arcs; assert(arc_valid(&arcs[s])); return capacity[s]; }
+            FlowType lower_bound(EdgeId i) const { assert(arc_valid(&arcs[i])); const EdgeId s = arcs[i].sister; assert(arc_valid(&arcs[s])); return capacity[s]; }
             CostType potential(NodeId i) const { assert(i<no_nodes()); return nodes[i].pi; }
+            // bytes allocated for nodes, arcs, capacities and the CSR copy
+            std::size_t memory_footprint() const;
 
             // debug functions
             bool TestOptimality() const; 
             bool TestCosts() const;
             void print_flow() const;
 
+            // binary snapshot of the complete solver state (topology, capacities, costs, residual capacities,
+            // potentials and excesses) without pointers. load_snapshot replaces the current content, after which
+            // solving can continue with resolve().
+            void save_snapshot(const std::string& filename) const;
+            void load_snapshot(const std::string& filename);
+
+            // statistics, collected only if SSP_STATISTICS is defined. They accumulate until reset_statistics() is called.
+            struct Statistics
+            {
+                std::size_t dijkstra_calls = 0; // shortest path computations, one per phase in solve_primal_dual()
+                std::size_t nodes_settled = 0;
+                std::size_t arcs_relaxed = 0; // residual arcs scanned out of settled nodes
+                std::size_t heap_adds = 0;
+                std::size_t heap_decrease_keys = 0;
+                std::size_t heap_remove_mins = 0;
+                std::size_t augmentations = 0;
+                std::size_t augmenting_path_arcs = 0; // summed over all augmentations
+                std::size_t max_augmenting_path_arcs = 0;
+                FlowType augmented_flow = 0; // summed over all augmentations
+                FlowType max_augmented_flow = 0;
+                std::size_t presaturated_arcs = 0; // arcs with negative reduced cost saturated in add_edge, add_edges, build or Init()
+                std::size_t refine_phases = 0; // epsilon phases of solve_cost_scaling()
+                double order_seconds = 0.0;
+                double init_seconds = 0.0;
+                double main_loop_seconds = 0.0; // shortest path computations and augmentations
+            };
+            // counters of a single shortest path computation, passed to the trace callback when it finishes
+            struct Iteration
+            {
+                NodeId start = 0; // no_nodes() for the multi-source search of solve_primal_dual()
+                std::size_t nodes_settled = 0;
+                std::size_t arcs_relaxed = 0;
+                std::size_t augmentations = 0;
+                std::size_t path_arcs = 0;
+                FlowType delta = 0; // flow sent
+            };
+            const Statistics& statistics() const { return stats; }
+            void reset_statistics() { stats = Statistics(); }
+            // callback invoked after every shortest path computation. Like the statistics it is only called if SSP_STATISTICS
+            // is defined, otherwise it is stored but never invoked.
+            void set_trace(std::function<void(const Iteration&)> callback) { trace = std::move(callback); }
+
             /////////////////////////////////////////////////////////////////////////
             /////////////////////////////////////////////////////////////////////////
             /////////////////////////////////////////////////////////////////////////
@@ -95,41 +596,45 @@ namespace MCF {
             struct Node;
             struct Arc;
 
+            // nodes and arcs refer to each other by IndexType positions in nodes and arcs, none marks the empty reference
+            static constexpr IndexType none = std::numeric_limits<IndexType>::max();
+
             struct Node
             {
-                Arc			*firstNonsaturated;
-                Arc			*firstSaturated;
+                IndexType	firstNonsaturated; // arc
+                IndexType	firstSaturated; // arc
 
-                Arc			*parent;
-                Node		*next; // list of nodes with positive excesses
+                IndexType	parent; // arc
+                IndexType	next; // list of nodes with positive excesses, none if not in the list
 
                 FlowType	excess;
                 CostType	pi;
-                std::size_t			flag;
+                IndexType	flag; // value of counter of the search that has labeled the node
                 union
                 {
-                    std::size_t		heap_ptr;
-                    Node*	next_permanent;
+                    IndexType	heap_ptr;
+                    IndexType	next_permanent; // node
+                    IndexType	current; // current arc in BlockingFlow
                 };
             };
 
             struct Arc
             {
-                Node		*head;
-                Arc			*prev;    // previous arc in saturated or non-saturated list
-                Arc			*next;    // next arc in saturated or non-saturated list
-                Arc			*sister;	// reverse arc
+                IndexType	head;
+                IndexType	prev;    // previous arc in saturated or non-saturated list
+                IndexType	next;    // next arc in saturated or non-saturated list
+                IndexType	sister;	// reverse arc
 
                 FlowType	r_cap;		// residual capacity
                 CostType	cost;
-                CostType GetRCost() const { return cost + head->pi - sister->head->pi; }
             };
 
-            std::size_t		nodeNum, edgeNum, edgeNumMax;
+            std::size_t		nodeNum, nodeNumMax, edgeNum, edgeNumMax; // nodeNumMax and edgeNumMax are the allocated sizes
             Node	*nodes = nullptr;
             Arc		*arcs = nullptr;
-            Node*	firstActive = nullptr;
-            std::size_t		counter;
+            IndexType	firstActive = 0; // list of active nodes, terminated by nodeNum
+            std::vector<IndexType> edgeArc; // arc of each edge after reordering, empty if arcs were never reordered
+            IndexType	counter; // last flag handed out by NextFlag()
             CostType mcf_cost;
 
             FlowType* capacity = nullptr; // original capacities from which one can compute the flows
@@ -137,27 +642,74 @@ namespace MCF {
 
             /////////////////////////////////////////////////////////////////////////
 
-            struct PriorityQueue
-            {
-                PriorityQueue();
-                ~PriorityQueue();
-                void Reset();
-                CostType GetKey(Node* i);
-                void Add(Node* i, CostType key);
-                void DecreaseKey(Node* i, CostType key);
-                Node* RemoveMin(CostType& key);
+            PriorityQueue<Node, CostType> queue;
 
-                private:
-                struct Item
-                {
-                    Node*		i;
-                    CostType	key;
-                }* array;
-                std::size_t N, arraySize;
-                void Swap(std::size_t k1, std::size_t k2);
+            /////////////////////////////////////////////////////////////////////////
+
+            // forward-star layout used by solve_csr(). Outgoing arcs of node i are at positions first[i],...,first[i+1]-1.
+            struct CSR
+            {
+                std::vector<IndexType> first;
+                std::vector<IndexType> head;
+                std::vector<FlowType>  r_cap;
+                std::vector<CostType>  cost;
+                std::vector<IndexType> sister;
+                std::vector<IndexType> arc; // position in arcs
+                std::vector<IndexType> parent; // per node, arc on shortest path tree
             };
 
-            PriorityQueue queue;
+            CSR csr;
+
+            /////////////////////////////////////////////////////////////////////////
+
+            Statistics stats;
+            Iteration iteration;
+            std::function<void(const Iteration&)> trace;
+
+            static CostType FloorDiv(const CostType a, const CostType b, std::true_type) { return a/b - (a % b < 0 ? 1 : 0); }
+            static CostType FloorDiv(const CostType a, const CostType b, std::false_type) { return std::floor(a/b); }
+            static double SecondsSince(const std::chrono::steady_clock::time_point begin)
+            {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            }
+            void BeginIteration(const NodeId start)
+            {
+                iteration = Iteration();
+                iteration.start = start;
+                stats.dijkstra_calls++;
+            }
+            void EndIteration()
+            {
+                stats.nodes_settled += iteration.nodes_settled;
+                stats.arcs_relaxed += iteration.arcs_relaxed;
+                if (trace) trace(iteration);
+            }
+            void RecordAugmentation(const std::size_t path_arcs, const FlowType delta)
+            {
+                iteration.augmentations++;
+                iteration.path_arcs += path_arcs;
+                iteration.delta += delta;
+                stats.augmentations++;
+                stats.augmenting_path_arcs += path_arcs;
+                stats.max_augmenting_path_arcs = std::max(stats.max_augmenting_path_arcs, path_arcs);
+                stats.augmented_flow += delta;
+                stats.max_augmented_flow = std::max(stats.max_augmented_flow, delta);
+            }
+
+            /////////////////////////////////////////////////////////////////////////
+
+            void BuildCSR();
+            void WriteBackCSR();
+            // one phase of solve_cost_scaling() on csr with scaled costs and potentials: turn a pseudoflow into an epsilon-optimal flow
+            void Refine(CostType epsilon, std::vector<CostType>& pi, std::vector<FlowType>& excess);
+            // global price update: raise potentials by epsilon times the distance to the nearest deficit, keeps epsilon-optimality
+            void PriceUpdate(CostType epsilon, std::vector<CostType>& pi, const std::vector<FlowType>& excess);
+            // exact potentials for the optimal flow in csr by label correcting, starting from the ones given. Returns false
+            // if some potential is lowered more than no_nodes() times, i.e. the residual network has a negative cycle
+            bool RepairPotentials(std::vector<CostType>& pi) const;
+            FlowType AugmentCSR(Node* start, Node* end);
+            void DijkstraCSR(Node* start);
+            void LinkArcs(); // rebuild saturated and non-saturated lists from residual capacities
 
             /////////////////////////////////////////////////////////////////////////
 
@@ -165,17 +717,44 @@ namespace MCF {
             void PushFlow(Arc* a, FlowType delta);
 
             void Init();
+            void ProcessActive(); // run Dijkstra from active nodes until all excesses are routed
             void DecreaseRCap(Arc* a, FlowType delta);
             void IncreaseRCap(Arc* a, FlowType delta);
             FlowType Augment(Node* start, Node* end);
-            void Dijkstra(Node* start);
+            // search for a node with negative excess and augment along a shortest path. Returns false if none is reachable
+            bool Dijkstra(Node* start) { return Dijkstra<false>(start, 0); }
+            // capacity scaling phase: search for a node with excess <= -delta using only arcs with r_cap >= delta
+            bool Dijkstra(Node* start, FlowType delta) { return Dijkstra<true>(start, delta); }
+            template<bool SCALING> bool Dijkstra(Node* start, FlowType delta);
+            bool DijkstraMultiSource(); // returns false if no node has positive excess
+            void BlockingFlow();
+
+            Arc* ArcPtr(const IndexType a) const { return a == none ? nullptr : arcs + a; }
+            IndexType Index(const Arc* a) const { return a ? IndexType(a - arcs) : none; }
+            Node* NodePtr(const IndexType i) const { return i == none ? nullptr : nodes + i; }
+            IndexType Index(const Node* i) const { return i ? IndexType(i - nodes) : none; }
+            // fresh flag for labeling nodes. Before counter would reach none, all flags are cleared and counting starts again
+            IndexType NextFlag()
+            {
+                if (counter == none-1)
+                {
+                    for (std::size_t i=0; i<nodeNum; ++i) nodes[i].flag = 0;
+                    counter = 0;
+                }
+                return ++ counter;
+            }
+            Node* Head(const Arc* a) const { return nodes + a->head; }
+            Node* Tail(const Arc* a) const { return nodes + arcs[a->sister].head; }
+            Arc* Sister(const Arc* a) const { return arcs + a->sister; }
+            CostType GetRCost(const Arc* a) const { return a->cost + nodes[a->head].pi - nodes[arcs[a->sister].head].pi; }
 
             bool node_valid(NodeId i) const;
             bool arc_valid(Arc* a) const;
-            void exchange(Arc* const a, Arc* const b);
 
-            void order_inter_nodes(); // reorder arcs so that the outgoing ones from each node are ordered consecutively.
-            void order_intra_nodes(); // reorder arcs outgoing from each node by head node id
+            // positions of arcs 0,...,no_arcs-1 when sorted by (tail, head), ties keep their order.
+            // Parallel counting sort with no_threads threads (0: choose automatically)
+            template <typename TAIL, typename HEAD>
+                std::vector<IndexType> SortArcs(std::size_t no_arcs, TAIL tail_of, HEAD head_of, std::size_t no_threads) const;
     };
 
 
@@ -184,14 +763,14 @@ namespace MCF {
     // Implementation - inline functions //
     ///////////////////////////////////////
 
-    template <typename FlowType, typename CostType> 
-        inline FlowType SSP<FlowType, CostType>::flow(EdgeId _e) const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline FlowType SSP<FlowType, CostType, PriorityQueue, IndexType>::flow(EdgeId _e) const
         {
             return capacity[_e] - arcs[_e].r_cap;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline FlowType SSP<FlowType, CostType>::flow(NodeId _i, EdgeId _e) const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline FlowType SSP<FlowType, CostType, PriorityQueue, IndexType>::flow(NodeId _i, EdgeId _e) const
         {
             assert(false);
             EdgeId e = (nodes[_i].first() + _e) - arcs;
@@ -199,111 +778,113 @@ namespace MCF {
         }
 
 
-    template <typename FlowType, typename CostType> 
-        inline typename SSP<FlowType, CostType>::NodeId SSP<FlowType, CostType>::no_nodes() const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline typename SSP<FlowType, CostType, PriorityQueue, IndexType>::NodeId SSP<FlowType, CostType, PriorityQueue, IndexType>::no_nodes() const
         {
             return nodeNum;
         }
-    template <typename FlowType, typename CostType> 
-        inline typename SSP<FlowType, CostType>::EdgeId SSP<FlowType, CostType>::no_edges() const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline typename SSP<FlowType, CostType, PriorityQueue, IndexType>::EdgeId SSP<FlowType, CostType, PriorityQueue, IndexType>::no_edges() const
         {
             return edgeNum;
         }
-    template <typename FlowType, typename CostType> 
-        inline typename SSP<FlowType, CostType>::EdgeId SSP<FlowType, CostType>::no_arcs() const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline typename SSP<FlowType, CostType, PriorityQueue, IndexType>::EdgeId SSP<FlowType, CostType, PriorityQueue, IndexType>::no_arcs() const
         {
             return 2*edgeNum;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline std::size_t SSP<FlowType, CostType>::no_outgoing_arcs(NodeId i) const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline std::size_t SSP<FlowType, CostType, PriorityQueue, IndexType>::no_outgoing_arcs(NodeId i) const
         {
             assert(node_valid(i));
             std::size_t n = 0;
-            for (Arc* a=nodes[i].firstSaturated; a; a=a->next) { ++n; }
-            for (Arc* a=nodes[i].firstNonsaturated; a; a=a->next) { ++n; }
+            for (IndexType a=nodes[i].firstSaturated; a!=none; a=arcs[a].next) { ++n; }
+            for (IndexType a=nodes[i].firstNonsaturated; a!=none; a=arcs[a].next) { ++n; }
             return n;
         }
 
     // only makes sense if arcs have been ordered
-    template <typename FlowType, typename CostType> 
-        inline typename SSP<FlowType, CostType>::EdgeId SSP<FlowType, CostType>::first_outgoing_arc(NodeId i) const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline typename SSP<FlowType, CostType, PriorityQueue, IndexType>::EdgeId SSP<FlowType, CostType, PriorityQueue, IndexType>::first_outgoing_arc(NodeId i) const
         {
             assert(node_valid(i));
             EdgeId e = std::numeric_limits<EdgeId>::max();
-            for (Arc* a=nodes[i].firstSaturated; a; a=a->next) { 
-                e = std::min(e, EdgeId(a-arcs));
+            for (IndexType a=nodes[i].firstSaturated; a!=none; a=arcs[a].next) { 
+                e = std::min(e, EdgeId(a));
             }
-            for (Arc* a=nodes[i].firstNonsaturated; a; a=a->next) { 
-                e = std::min(e, EdgeId(a-arcs));
+            for (IndexType a=nodes[i].firstNonsaturated; a!=none; a=arcs[a].next) { 
+                e = std::min(e, EdgeId(a));
             }
             return e;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::add_node_excess(NodeId _i, FlowType excess)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::add_node_excess(NodeId _i, FlowType excess)
         {
-            assert(_i>=0 && _i<nodeNum);
+            assert(_i<nodeNum);
             nodes[_i].excess += excess;
-            if (nodes[_i].excess > 0 && !nodes[_i].next)
+            if (nodes[_i].excess > 0 && nodes[_i].next == none)
             {
                 nodes[_i].next = firstActive;
-                firstActive = &nodes[_i];
+                firstActive = _i;
             }
         }
 
-    template <typename FlowType, typename CostType> 
-        inline typename SSP<FlowType, CostType>::EdgeId SSP<FlowType, CostType>::add_edge(NodeId _i, NodeId _j, FlowType lower, FlowType upper, CostType cost)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline typename SSP<FlowType, CostType, PriorityQueue, IndexType>::EdgeId SSP<FlowType, CostType, PriorityQueue, IndexType>::add_edge(NodeId _i, NodeId _j, FlowType lower, FlowType upper, CostType cost)
         {
-            assert(_i>=0 && _i<nodeNum);
-            assert(_j>=0 && _j<nodeNum);
+            assert(_i<nodeNum);
+            assert(_j<nodeNum);
             assert(_i!=_j && edgeNum<edgeNumMax);
             assert(upper >= 0);
             assert(lower <= 0);
             assert(lower < upper);
 
-            Arc *a = &arcs[2*edgeNum];
+            const IndexType a_idx = 2*edgeNum;
+            const IndexType a_rev_idx = a_idx+1;
+            Arc *a = &arcs[a_idx];
             Arc *a_rev = a+1;
 
-            capacity[2*edgeNum] = upper;
-            capacity[2*edgeNum+1] = lower;
+            capacity[a_idx] = upper;
+            capacity[a_rev_idx] = lower;
 
             edgeNum ++;
 
             Node* i = nodes + _i;
             Node* j = nodes + _j;
 
-            a -> sister = a_rev;
-            a_rev -> sister = a;
+            a -> sister = a_rev_idx;
+            a_rev -> sister = a_idx;
             if (upper > 0)
             {
-                if (i->firstNonsaturated) i->firstNonsaturated->prev = a;
+                if (i->firstNonsaturated != none) arcs[i->firstNonsaturated].prev = a_idx;
                 a -> next = i -> firstNonsaturated;
-                i -> firstNonsaturated = a;
+                i -> firstNonsaturated = a_idx;
             }
             else
             {
-                if (i->firstSaturated) i->firstSaturated->prev = a;
+                if (i->firstSaturated != none) arcs[i->firstSaturated].prev = a_idx;
                 a -> next = i -> firstSaturated;
-                i -> firstSaturated = a;
+                i -> firstSaturated = a_idx;
             }
-            a->prev = nullptr;
+            a->prev = none;
             if (lower < 0)
             {
-                if (j->firstNonsaturated) j->firstNonsaturated->prev = a_rev;
+                if (j->firstNonsaturated != none) arcs[j->firstNonsaturated].prev = a_rev_idx;
                 a_rev -> next = j -> firstNonsaturated;
-                j -> firstNonsaturated = a_rev;
+                j -> firstNonsaturated = a_rev_idx;
             }
             else
             {
-                if (j->firstSaturated) j->firstSaturated->prev = a_rev;
+                if (j->firstSaturated != none) arcs[j->firstSaturated].prev = a_rev_idx;
                 a_rev -> next = j -> firstSaturated;
-                j -> firstSaturated = a_rev;
+                j -> firstSaturated = a_rev_idx;
             }
-            a_rev->prev = nullptr;
+            a_rev->prev = none;
 
-            a -> head = j;
-            a_rev -> head = i;
+            a -> head = _j;
+            a_rev -> head = _i;
             a -> r_cap = upper;
             a_rev -> r_cap = -lower;
             a -> cost = cost;
@@ -311,60 +892,99 @@ namespace MCF {
 
             assert(arc_valid(a) && arc_valid(a_rev));
 
-            if (a->r_cap > 0 && a->GetRCost() < 0) PushFlow(a, a->r_cap);
-            if (a_rev->r_cap > 0 && a_rev->GetRCost() < 0) PushFlow(a_rev, a_rev->r_cap);
+            if (a->r_cap > 0 && GetRCost(a) < 0) { PushFlow(a, a->r_cap); SSP_STAT(stats.presaturated_arcs++;) }
+            if (a_rev->r_cap > 0 && GetRCost(a_rev) < 0) { PushFlow(a_rev, a_rev->r_cap); SSP_STAT(stats.presaturated_arcs++;) }
 
             assert(arc_valid(a) && arc_valid(a_rev));
             return edgeNum-1;
         }
 
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::add_edges(const std::vector<NodeId>& tails, const std::vector<NodeId>& heads,
+                const std::vector<FlowType>& lower, const std::vector<FlowType>& upper, const std::vector<CostType>& cost)
+        {
+            const std::size_t k = tails.size();
+            assert(heads.size() == k && lower.size() == k && upper.size() == k && cost.size() == k);
+            assert(edgeNum + k <= edgeNumMax);
+
+            Arc* a = &arcs[2*edgeNum];
+            FlowType* c = &capacity[2*edgeNum];
+            for (std::size_t e=0; e<k; ++e, a+=2, c+=2)
+            {
+                assert(tails[e] < nodeNum && heads[e] < nodeNum && tails[e] != heads[e]);
+                assert(upper[e] >= 0 && lower[e] <= 0 && lower[e] < upper[e]);
+                Arc* a_rev = a+1;
+                c[0] = upper[e];
+                c[1] = lower[e];
+                a->sister = Index(a_rev);
+                a_rev->sister = Index(a);
+                a->head = heads[e];
+                a_rev->head = tails[e];
+                a->r_cap = upper[e];
+                a_rev->r_cap = -lower[e];
+                a->cost = cost[e];
+                a_rev->cost = -cost[e];
+            }
+            const EdgeId first_new = 2*edgeNum;
+            edgeNum += k;
+            LinkArcs();
+
+            // as in add_edge, arcs with negative reduced cost are saturated
+            for (a=&arcs[first_new]; a<arcs+2*edgeNum; a++)
+            {
+                if (a->r_cap > 0 && GetRCost(a) < 0) { PushFlow(a, a->r_cap); SSP_STAT(stats.presaturated_arcs++;) }
+            }
+        }
+
     ///////////////////////////////////////
     ///////////////////////////////////////
     ///////////////////////////////////////
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::DecreaseRCap(Arc* a, FlowType delta)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::DecreaseRCap(Arc* a, FlowType delta)
         {
             a->r_cap -= delta;
             if (a->r_cap == 0)
             {
-                Node* i = a->sister->head;
-                if (a->next) a->next->prev = a->prev;
-                if (a->prev) a->prev->next = a->next;
-                else         i->firstNonsaturated = a->next;
+                Node* i = Tail(a);
+                const IndexType a_idx = Index(a);
+                if (a->next != none) arcs[a->next].prev = a->prev;
+                if (a->prev != none) arcs[a->prev].next = a->next;
+                else                 i->firstNonsaturated = a->next;
                 a->next = i->firstSaturated;
-                if (a->next) a->next->prev = a;
-                a->prev = nullptr;
-                i->firstSaturated = a;
+                if (a->next != none) arcs[a->next].prev = a_idx;
+                a->prev = none;
+                i->firstSaturated = a_idx;
             }
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::IncreaseRCap(Arc* a, FlowType delta)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::IncreaseRCap(Arc* a, FlowType delta)
         {
             if (a->r_cap == 0)
             {
-                Node* i = a->sister->head;
-                if (a->next) a->next->prev = a->prev;
-                if (a->prev) a->prev->next = a->next;
-                else         i->firstSaturated = a->next;
+                Node* i = Tail(a);
+                const IndexType a_idx = Index(a);
+                if (a->next != none) arcs[a->next].prev = a->prev;
+                if (a->prev != none) arcs[a->prev].next = a->next;
+                else                 i->firstSaturated = a->next;
                 a->next = i->firstNonsaturated;
-                if (a->next) a->next->prev = a;
-                a->prev = nullptr;
-                i->firstNonsaturated = a;
+                if (a->next != none) arcs[a->next].prev = a_idx;
+                a->prev = none;
+                i->firstNonsaturated = a_idx;
             }
             a->r_cap += delta;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline FlowType SSP<FlowType, CostType>::GetRCap(EdgeId e)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline FlowType SSP<FlowType, CostType, PriorityQueue, IndexType>::GetRCap(EdgeId e)
         {
             Arc* a = &arcs[2*e];
             return a->r_cap;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::SetRCap(Arc* a, FlowType new_rcap)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::SetRCap(Arc* a, FlowType new_rcap)
         {
             assert(new_rcap >= 0);
 #ifdef SSP_DEBUG
@@ -372,84 +992,98 @@ namespace MCF {
 #endif
             if (a->r_cap == 0)
             {
-                Node* i = a->sister->head;
-                if (a->next) a->next->prev = a->prev;
-                if (a->prev) a->prev->next = a->next;
-                else         i->firstSaturated = a->next;
+                Node* i = Tail(a);
+                const IndexType a_idx = Index(a);
+                if (a->next != none) arcs[a->next].prev = a->prev;
+                if (a->prev != none) arcs[a->prev].next = a->next;
+                else                 i->firstSaturated = a->next;
                 a->next = i->firstNonsaturated;
-                if (a->next) a->next->prev = a;
-                a->prev = nullptr;
-                i->firstNonsaturated = a;
+                if (a->next != none) arcs[a->next].prev = a_idx;
+                a->prev = none;
+                i->firstNonsaturated = a_idx;
             }
             a->r_cap = new_rcap;
             if (a->r_cap == 0)
             {
-                Node* i = a->sister->head;
-                if (a->next) a->next->prev = a->prev;
-                if (a->prev) a->prev->next = a->next;
-                else         i->firstNonsaturated = a->next;
+                Node* i = Tail(a);
+                const IndexType a_idx = Index(a);
+                if (a->next != none) arcs[a->next].prev = a->prev;
+                if (a->prev != none) arcs[a->prev].next = a->next;
+                else                 i->firstNonsaturated = a->next;
                 a->next = i->firstSaturated;
-                if (a->next) a->next->prev = a;
-                a->prev = nullptr;
-                i->firstSaturated = a;
+                if (a->next != none) arcs[a->next].prev = a_idx;
+                a->prev = none;
+                i->firstSaturated = a_idx;
             }
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::SetRCap(EdgeId e, FlowType new_rcap)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::SetRCap(EdgeId e, FlowType new_rcap)
         {
             SetRCap(&arcs[2*e], new_rcap);
         }
 
-    template <typename FlowType, typename CostType> 
-        inline FlowType SSP<FlowType, CostType>::GetReverseRCap(EdgeId e)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline FlowType SSP<FlowType, CostType, PriorityQueue, IndexType>::GetReverseRCap(EdgeId e)
         {
             Arc* a = &arcs[2*e+1];
             return a->r_cap;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::SetReverseRCap(EdgeId e, FlowType new_rcap)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::SetReverseRCap(EdgeId e, FlowType new_rcap)
         {
             SetRCap(&arcs[2*e+1], new_rcap);
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::PushFlow(Arc* a, FlowType delta)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::PushFlow(Arc* a, FlowType delta)
         {
-            if (delta < 0) { a = a->sister; delta = -delta; }
+            if (delta < 0) { a = Sister(a); delta = -delta; }
             DecreaseRCap(a, delta);
-            IncreaseRCap(a->sister, delta);
-            a->head->excess += delta;
-            a->sister->head->excess -= delta;
+            IncreaseRCap(Sister(a), delta);
+            Node* j = Head(a);
+            j->excess += delta;
+            Tail(a)->excess -= delta;
             mcf_cost += delta*a->cost;
-            if (a->head->excess > 0 && !a->head->next)
+            if (j->excess > 0 && j->next == none)
             {
-                a->head->next = firstActive;
+                j->next = firstActive;
                 firstActive = a->head;
             }
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::PushFlow(EdgeId e, FlowType delta)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::PushFlow(EdgeId e, FlowType delta)
         {
             PushFlow(&arcs[2*e], delta);
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::update_cost(EdgeId e, CostType delta)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::update_cost(EdgeId e, CostType delta)
         {
             Arc* a = &arcs[e];
             mcf_cost += delta*(capacity[e]-a->r_cap);
             a->cost += delta;
-            a->sister->cost = -a->cost;
+            Sister(a)->cost = -a->cost;
 
-            if (a->GetRCost() > 0) a = a->sister;
-            if (a->r_cap > 0 && a->GetRCost() < 0) PushFlow(a, a->r_cap);
+            if (GetRCost(a) > 0) a = Sister(a);
+            if (a->r_cap > 0 && GetRCost(a) < 0) PushFlow(a, a->r_cap);
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::update_capacity(EdgeId e, FlowType delta)
+        {
+            Arc* a = &arcs[e];
+            assert(a->r_cap + Sister(a)->r_cap + delta >= 0);
+            if (a->r_cap + delta < 0) PushFlow(a, a->r_cap + delta); // send surplus flow back along the sister arc
+            capacity[e] += delta;
+            SetRCap(a, a->r_cap + delta);
+            if (a->r_cap > 0 && GetRCost(a) < 0) PushFlow(a, a->r_cap);
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::reset_costs()
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::reset_costs()
         {
            for(EdgeId e=0; e<no_arcs(); ++e) {
               update_cost(e, -cost(e));
@@ -459,177 +1093,82 @@ namespace MCF {
            assert(objective() == 0.0);
         }
 
-    ///////////////////////////////////////
-    ///////////////////////////////////////
-    ///////////////////////////////////////
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline SSP<FlowType, CostType, PriorityQueue, IndexType>::SSP()
+        : nodeNum(0),
+        nodeNumMax(0),
+        edgeNum(0),
+        edgeNumMax(0),
+        nodes(nullptr),
+        arcs(nullptr),
+        firstActive(0),
+        counter(0),
+        mcf_cost(0),
+        capacity(nullptr)
+    {}
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline SSP<FlowType, CostType, PriorityQueue, IndexType>::SSP(std::size_t _nodeNum, std::size_t _edgeNumMax)
+        : SSP()
+    {
+        reset(_nodeNum, _edgeNumMax);
+    }
 
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType, CostType>::PriorityQueue::PriorityQueue()
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::reset(std::size_t _nodeNum, std::size_t _edgeNumMax)
         {
-            N = 0;
-            arraySize = 16;
-            array = (Item*) malloc(arraySize*sizeof(Item));
-        }
+            if (_nodeNum >= none || 2*_edgeNumMax > none)
+            { throw std::length_error("MCF::SSP: number of nodes or arcs exceeds the range of the index type"); }
 
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType, CostType>::PriorityQueue::~PriorityQueue()
-        {
-            if(array)
-                free(array);
-        }
+            // buffers only grow. Arcs need no initialization, add_edge and add_edges set all their fields
+            if (_nodeNum > nodeNumMax)
+            {
+                if(nodes != nullptr) free(nodes);
+                nodes = (Node*) malloc(_nodeNum*sizeof(Node));
+                nodeNumMax = nodes ? _nodeNum : 0;
+                if (!nodes) { throw std::bad_alloc(); }
+            }
+            if (_edgeNumMax > edgeNumMax)
+            {
+                if(arcs != nullptr) free(arcs);
+                if(capacity != nullptr) free(capacity);
+                arcs = (Arc*) malloc(2*_edgeNumMax*sizeof(Arc));
+                capacity = (FlowType*) malloc(2*_edgeNumMax*sizeof(FlowType));
+                edgeNumMax = (arcs && capacity) ? _edgeNumMax : 0;
+                if (!arcs || !capacity) { throw std::bad_alloc(); }
+            }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::PriorityQueue::Reset()
-        {
-            N = 0;
+            nodeNum = _nodeNum;
+            edgeNum = 0;
+            mcf_cost = 0;
+            edgeArc.clear();
+            for (Node* i=nodes; i<nodes+nodeNum; i++)
+            {
+                std::memset(i, 0, sizeof(Node));
+                i->firstNonsaturated = i->firstSaturated = i->parent = i->next = none;
+            }
+            firstActive = nodeNum;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline CostType SSP<FlowType, CostType>::PriorityQueue::GetKey(Node* i)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::copy_node(const SSP& o, NodeId i)
         {
-            return array[i->heap_ptr].key;
+            nodes[i] = o.nodes[i];
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::PriorityQueue::Swap(std::size_t k1, std::size_t k2)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::copy_arc(const SSP& o, EdgeId i)
         {
-            Item* a = array+k1;
-            Item* b = array+k2;
-            a->i->heap_ptr = k2;
-            b->i->heap_ptr = k1;
-            Node* i = a->i;   a->i   = b->i;   b->i   = i;
-            CostType key = a->key; a->key = b->key; b->key = key;
+            arcs[i] = o.arcs[i];
+            capacity[i] = o.capacity[i];
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::PriorityQueue::Add(Node* i, CostType key)
-        {
-            if (N == arraySize)
-            {
-                arraySize *= 2;
-                array = (Item*) realloc(array, arraySize*sizeof(Item));
-            }
-            std::size_t k = i->heap_ptr = N ++;
-            array[k].i = i;
-            array[k].key = key;
-            while (k > 0)
-            {
-                std::size_t k2 = (k-1)/2;
-                if (array[k2].key <= array[k].key) break;
-                Swap(k, k2);
-                k = k2;
-            }
-        }
-
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::PriorityQueue::DecreaseKey(Node* i, CostType key)
-        {
-            std::size_t k = i->heap_ptr;
-            array[k].key = key;
-            while (k > 0)
-            {
-                std::size_t k2 = (k-1)/2;
-                if (array[k2].key <= array[k].key) break;
-                Swap(k, k2);
-                k = k2;
-            }
-        }
-
-    template <typename FlowType, typename CostType> 
-        inline typename SSP<FlowType, CostType>::Node* SSP<FlowType, CostType>::PriorityQueue::RemoveMin(CostType& key)
-        {
-            if (N == 0) return nullptr;
-
-            Swap(0, N-1);
-            N --;
-
-            std::size_t k = 0;
-            while ( 1 )
-            {
-                std::size_t k1 = 2*k + 1, k2 = k1 + 1;
-                if (k1 >= N) break;
-                std::size_t k_min = (k2 >= N || array[k1].key <= array[k2].key) ? k1 : k2;
-                if (array[k].key <= array[k_min].key) break;
-                Swap(k, k_min);
-                k = k_min;
-            }
-
-            key = array[N].key;
-            return array[N].i;
-        }
-
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType, CostType>::SSP()
-        : nodeNum(0),
-        edgeNum(0),
-        edgeNumMax(0),
-        counter(0),
-        mcf_cost(0),
-        nodes(nullptr),
-        arcs(nullptr),
-        capacity(nullptr),
-        firstActive(nullptr)
-    {}
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType, CostType>::SSP(std::size_t _nodeNum, std::size_t _edgeNumMax)
-        : nodeNum(_nodeNum),
-        edgeNum(0),
-        edgeNumMax(_edgeNumMax),
-        counter(0),
-        mcf_cost(0)
-    {
-        if(nodeNum > 0) { nodes = (Node*) malloc(nodeNum*sizeof(Node)); }
-        if(edgeNumMax > 0) { arcs = (Arc*) malloc(2*edgeNumMax*sizeof(Arc)); }
-        if(edgeNumMax > 0) { capacity = (FlowType*) malloc(2*edgeNumMax*sizeof(FlowType)); }
-        if ((nodeNum > 0 && !nodes) || 
-                (edgeNumMax > 0 && !arcs) || 
-                (edgeNumMax > 0 && !capacity) )
-        { throw std::bad_alloc(); }
-
-        std::memset(nodes, 0, nodeNum*sizeof(Node));
-        std::memset(arcs, 0, 2*edgeNumMax*sizeof(Arc));
-        firstActive = &nodes[nodeNum];
-    }
-
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::copy_node(const SSP& o, NodeId i)
-        {
-            if(o.nodes[i].firstNonsaturated != nullptr) { nodes[i].firstNonsaturated = arcs + (o.nodes[i].firstNonsaturated - o.arcs); }
-            else { nodes[i].firstNonsaturated = nullptr; }
-            if(o.nodes[i].firstSaturated != nullptr) { nodes[i].firstSaturated = arcs + (o.nodes[i].firstSaturated - o.arcs); }
-            else { nodes[i].firstSaturated = nullptr; }
-            if(o.nodes[i].parent != nullptr) { nodes[i].parent = arcs + (o.nodes[i].parent - o.arcs); }
-            else { nodes[i].parent = nullptr; }
-            if(o.nodes[i].next != nullptr) { nodes[i].next = nodes + (o.nodes[i].next - o.nodes); }
-            else { nodes[i].next = nullptr; }
-
-            nodes[i].excess = o.nodes[i].excess;
-            nodes[i].pi = o.nodes[i].pi;
-            nodes[i].flag = o.nodes[i].flag;
-        }
-
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::copy_arc(const SSP& o, EdgeId i)
-        {
-            arcs[i].head = nodes + (o.arcs[i].head - o.nodes);
-            arcs[i].sister = arcs + (o.arcs[i].sister - o.arcs);
-
-            if(o.arcs[i].next != nullptr) { arcs[i].next = arcs + (o.arcs[i].next - o.arcs); }
-            else { arcs[i].next = nullptr; }
-            if(o.arcs[i].prev != nullptr) { arcs[i].prev = arcs + (o.arcs[i].prev - o.arcs); }
-            else { arcs[i].prev = nullptr; }
-
-            arcs[i].r_cap = o.arcs[i].r_cap;
-            arcs[i].cost = o.arcs[i].cost;
-
-            capacity[i] = o.capacity[i];
-        }
-
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType, CostType>::SSP(const SSP& o)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline SSP<FlowType, CostType, PriorityQueue, IndexType>::SSP(const SSP& o)
         : nodeNum(o.nodeNum),
+        nodeNumMax(o.nodeNum),
         edgeNum(o.edgeNum),
         edgeNumMax(o.edgeNumMax),
+        edgeArc(o.edgeArc),
         counter(o.counter),
         mcf_cost(o.mcf_cost)
     {
@@ -641,15 +1180,16 @@ namespace MCF {
         for(NodeId i=0; i<nodeNum; ++i) { copy_node(o,i); }
         for(EdgeId i=0; i<2*edgeNum; ++i) { copy_arc(o,i); }
 
-        firstActive = nodes + (o.firstActive - o.nodes);
+        firstActive = o.firstActive;
     }
 
-    template <typename FlowType, typename CostType> 
-        inline void swap(SSP<FlowType,CostType>& first, SSP<FlowType,CostType>& second)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void swap(SSP<FlowType,CostType,PriorityQueue,IndexType>& first, SSP<FlowType,CostType,PriorityQueue,IndexType>& second)
         {
             using std::swap;
 
             std::swap(first.nodeNum, second.nodeNum);
+            std::swap(first.nodeNumMax, second.nodeNumMax);
             std::swap(first.edgeNum, second.edgeNum);
             std::swap(first.edgeNumMax, second.edgeNumMax);
             std::swap(first.counter, second.counter);
@@ -659,79 +1199,89 @@ namespace MCF {
             std::swap(first.nodes, second.nodes);
             std::swap(first.arcs, second.arcs);
             std::swap(first.capacity, second.capacity);
+            std::swap(first.edgeArc, second.edgeArc);
+            std::swap(first.csr, second.csr);
+            std::swap(first.stats, second.stats);
+            std::swap(first.trace, second.trace);
         }
 
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType, CostType>::SSP(SSP&& o)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline SSP<FlowType, CostType, PriorityQueue, IndexType>::SSP(SSP&& o)
+        : SSP()
         {
             swap(*this, o);
         } 
 
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType,CostType>& SSP<FlowType, CostType>::operator=(SSP<FlowType,CostType>& o)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline SSP<FlowType,CostType,PriorityQueue,IndexType>& SSP<FlowType, CostType, PriorityQueue, IndexType>::operator=(SSP<FlowType,CostType,PriorityQueue,IndexType>& o)
         {
-            SSP<FlowType,CostType> o2(o);
+            SSP<FlowType,CostType,PriorityQueue,IndexType> o2(o);
             swap(*this, o2);
             return *this;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType,CostType>& SSP<FlowType, CostType>::operator=(SSP<FlowType,CostType>&& o)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline SSP<FlowType,CostType,PriorityQueue,IndexType>& SSP<FlowType, CostType, PriorityQueue, IndexType>::operator=(SSP<FlowType,CostType,PriorityQueue,IndexType>&& o)
         {
             swap(*this, o);
             return *this; 
         }
 
-    template <typename FlowType, typename CostType> 
-        inline SSP<FlowType, CostType>::~SSP()
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline SSP<FlowType, CostType, PriorityQueue, IndexType>::~SSP()
         {
             if(nodes != nullptr) free(nodes);
             if(arcs != nullptr) free(arcs);
             if(capacity != nullptr) free(capacity);
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::Init()
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::Init()
         {
+            SSP_STAT(const auto begin = std::chrono::steady_clock::now();)
             Node* i;
             Arc* a;
 
             for (a=arcs; a<arcs+2*edgeNum; a++)
             {
-                if (a->r_cap > 0 && a->GetRCost() < 0) PushFlow(a, a->r_cap);
+                if (a->r_cap > 0 && GetRCost(a) < 0) { PushFlow(a, a->r_cap); SSP_STAT(stats.presaturated_arcs++;) }
             }
 
-            Node** lastActivePtr = &firstActive;
+            IndexType* lastActivePtr = &firstActive;
             for (i=nodes; i<nodes+nodeNum; i++)
             {
                 if (i->excess > 0)
                 {
-                    *lastActivePtr = i;
+                    *lastActivePtr = i - nodes;
                     lastActivePtr = &i->next;
                 }
-                else i->next = nullptr;
+                else i->next = none;
             }
-            *lastActivePtr = &nodes[nodeNum];
+            *lastActivePtr = nodeNum;
+            SSP_STAT(stats.init_seconds += SecondsSince(begin);)
         }
 
 
-    template <typename FlowType, typename CostType> 
-        inline FlowType SSP<FlowType, CostType>::Augment(Node* start, Node* end)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline FlowType SSP<FlowType, CostType, PriorityQueue, IndexType>::Augment(Node* start, Node* end)
         {
             FlowType delta = (start->excess < -end->excess) ? start->excess : -end->excess;
             Arc* a;
+            SSP_STAT(std::size_t path_arcs = 0;)
 
-            for (a=end->parent; a; a=a->sister->head->parent)
+            for (a=ArcPtr(end->parent); a; a=ArcPtr(Tail(a)->parent))
             {
                 if (delta > a->r_cap) delta = a->r_cap;
+                SSP_STAT(path_arcs++;)
             }
             assert(delta > 0);
+            SSP_STAT(RecordAugmentation(path_arcs, delta);)
 
             end->excess += delta;
-            for (a=end->parent; a; a=a->head->parent)
+            for (a=ArcPtr(end->parent); a; a=ArcPtr(Head(a)->parent))
             {
                 DecreaseRCap(a, delta);
-                a = a->sister;
+                a = Sister(a);
                 IncreaseRCap(a, delta);
             }
             start->excess -= delta;
@@ -739,8 +1289,9 @@ namespace MCF {
             return delta;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::Dijkstra(Node* start)
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+    template <bool SCALING>
+        inline bool SSP<FlowType, CostType, PriorityQueue, IndexType>::Dijkstra(Node* start, FlowType delta)
         {
             assert(start->excess > 0);
 
@@ -748,412 +1299,2324 @@ namespace MCF {
             Node* j;
             Arc* a;
             CostType d;
+            CostType dist = 0; // distance of last permanently labeled node
             Node* permanentNodes;
 
-            std::size_t FLAG0 = ++ counter; // permanently labeled nodes
-            std::size_t FLAG1 = ++ counter; // temporarily labeled nodes
+            IndexType FLAG0 = NextFlag(); // permanently labeled nodes
+            IndexType FLAG1 = NextFlag(); // temporarily labeled nodes
 
-            start->parent = nullptr;
+            SSP_STAT(BeginIteration(start - nodes);)
+            start->parent = none;
             start->flag = FLAG1;
             queue.Reset();
             queue.Add(start, 0);
+            SSP_STAT(stats.heap_adds++;)
 
             permanentNodes = nullptr;
 
             while ( (i=queue.RemoveMin(d)) )
             {
                 assert(i != nullptr);
-                if (i->excess < 0)
+                SSP_STAT(stats.heap_remove_mins++;)
+                if (SCALING ? i->excess <= -delta : i->excess < 0)
                 {
-                    FlowType delta = Augment(start, i);
-                    mcf_cost += delta*(d - i->pi + start->pi);
-                    for (i=permanentNodes; i; i=i->next_permanent) i->pi += d;
-                    break;
+                    FlowType flow = Augment(start, i);
+                    mcf_cost += flow*(d - i->pi + start->pi);
+                    for (i=permanentNodes; i; i=NodePtr(i->next_permanent)) i->pi += d;
+                    SSP_STAT(EndIteration();)
+                    return true;
                 }
+                dist = d;
 
                 i->pi -= d;
                 i->flag = FLAG0;
-                i->next_permanent = permanentNodes;
+                i->next_permanent = Index(permanentNodes);
                 permanentNodes = i;
+                SSP_STAT(iteration.nodes_settled++;)
 
-                for (a=i->firstNonsaturated; a; a=a->next)
+                for (IndexType a_idx=i->firstNonsaturated; a_idx!=none; a_idx=a->next)
                 {
-                    j = a->head;
+                    a = arcs + a_idx;
+                    if (SCALING && a->r_cap < delta) continue;
+                    SSP_STAT(iteration.arcs_relaxed++;)
+                    j = Head(a);
                     if (j->flag == FLAG0) continue;
-                    d = a->GetRCost();
+                    d = a->cost + j->pi - i->pi;
                     if (j->flag == FLAG1)
                     {
                         if (d >= queue.GetKey(j)) continue;
                         queue.DecreaseKey(j, d);
+                        SSP_STAT(stats.heap_decrease_keys++;)
                     }
                     else
                     {
                         queue.Add(j, d);
+                        SSP_STAT(stats.heap_adds++;)
                         j->flag = FLAG1;
                     }
-                    j->parent = a;
+                    j->parent = a_idx;
                 }
 
             }
+
+            // no node with sufficient deficit is reachable. Shift potentials of all labeled nodes by the largest distance,
+            // so that reduced costs of arcs entering the labeled set stay non-negative.
+            for (i=permanentNodes; i; i=NodePtr(i->next_permanent)) i->pi += dist;
+            SSP_STAT(EndIteration();)
+            return false;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline bool SSP<FlowType, CostType>::node_valid(NodeId i) const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline bool SSP<FlowType, CostType, PriorityQueue, IndexType>::node_valid(NodeId i) const
         {
-            if(i < 0 || i >= nodeNum) { return false; }
-            if(nodes[i].firstSaturated != nullptr) {
-                if(nodes[i].firstSaturated < arcs) { return false; }
-                if(nodes[i].firstSaturated - arcs >= 2*edgeNum) { return false; }
-            }
-            if(nodes[i].firstNonsaturated != nullptr) {
-                if(nodes[i].firstNonsaturated < arcs) { return false; }
-                if(nodes[i].firstNonsaturated - arcs >= 2*edgeNum) { return false; }
-            }
+            if(i >= nodeNum) { return false; }
+            if(nodes[i].firstSaturated != none && nodes[i].firstSaturated >= 2*edgeNum) { return false; }
+            if(nodes[i].firstNonsaturated != none && nodes[i].firstNonsaturated >= 2*edgeNum) { return false; }
             return true;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline bool SSP<FlowType, CostType>::arc_valid(Arc* a) const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline bool SSP<FlowType, CostType, PriorityQueue, IndexType>::arc_valid(Arc* a) const
         {
             if(a < arcs || a >= arcs+2*edgeNum) { return false; }
-            if(!node_valid(tail(a-arcs))) { return false; }
-            if(!node_valid(head(a-arcs))) { return false; }
-            if(a->prev == a) { return false; }
-            if(a->next == a) { return false; }
-            if(a->sister->sister != a) { return false; }
-            if(a->next != nullptr && a->next->prev != a) { return false; }
-            if(a->prev != nullptr && a->prev->next != a) { return false; }
-
-            Node* a_tail = a->sister->head;
-            if(a_tail->firstSaturated == a && a->prev != nullptr) { return false; }
-            if(a_tail->firstNonsaturated == a && a->prev != nullptr) { return false; }
+            const IndexType a_idx = Index(a);
+            if(a->sister >= 2*edgeNum) { return false; }
+            if(!node_valid(tail(a_idx))) { return false; }
+            if(!node_valid(head(a_idx))) { return false; }
+            if(a->prev == a_idx) { return false; }
+            if(a->next == a_idx) { return false; }
+            if(Sister(a)->sister != a_idx) { return false; }
+            if(a->next != none && (a->next >= 2*edgeNum || arcs[a->next].prev != a_idx)) { return false; }
+            if(a->prev != none && (a->prev >= 2*edgeNum || arcs[a->prev].next != a_idx)) { return false; }
+
+            Node* a_tail = Tail(a);
+            if(a_tail->firstSaturated == a_idx && a->prev != none) { return false; }
+            if(a_tail->firstNonsaturated == a_idx && a->prev != none) { return false; }
 
             return true;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::exchange(Arc* const a, Arc* const b) 
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        template <typename TAIL, typename HEAD>
+        inline std::vector<IndexType> SSP<FlowType, CostType, PriorityQueue, IndexType>::SortArcs(const std::size_t no_arcs, TAIL tail_of, HEAD head_of, std::size_t no_threads) const
         {
-            assert(a >= arcs && a-arcs < 2*edgeNumMax);
-            assert(b >= arcs && b-arcs < 2*edgeNumMax);
-            assert(arc_valid(a) && arc_valid(b));
-            if ( a != b) {
-                Arc *sa = a->sister;
-                Arc *sb = b->sister;
-
-                Node* a_tail = a->sister->head;
-                Node* b_tail = b->sister->head;
-
-                Arc* na = a->next;
-                Arc* nb = b->next;
-
-                Arc* pa = a->prev;
-                Arc* pb = b->prev;
-
-                if(na) { assert(arc_valid(na)); }
-                if(nb) { assert(arc_valid(nb)); }
-                if(pa) { assert(arc_valid(pa)); }
-                if(pb) { assert(arc_valid(pb)); }
-
-                std::swap(a->head, b->head);
-                std::swap(a->r_cap, b->r_cap);
-                std::swap(a->cost, b->cost);
-                std::swap(capacity[a-arcs], capacity[b-arcs]);
-
-                if ( a != sb) {
-                    assert(b != sa);
-                    std::swap(a->sister, b->sister);
-                    sa->sister = b;
-                    sb->sister = a;
-                }
-
-                if(a->next == b) {
-                    assert(b->prev == a); 
-                    auto* b_next = b->next;
-                    auto* a_prev = a->prev;
-                    b->next = a;
-                    a->prev = b;
-                    a->next = b_next;
-                    b->prev = a_prev;
-                    if(b_next) { b_next->prev = a; }
-                    if(a_prev) { a_prev->next = b; }
-                } else if(b->next == a) {
-                    assert(a->prev == b);
-                    auto* a_next = a->next;
-                    auto* b_prev = b->prev;
-                    b->prev = a;
-                    a->next = b;
-                    a->prev = b_prev;
-                    b->next = a_next;
-                    if(a_next) { a_next->prev = b; }
-                    if(b_prev) { b_prev->next = a; }
-                } else {
-                    std::swap(a->next, b->next);
-                    std::swap(a->prev, b->prev); 
-                    if(na != nullptr) { na->prev = b; }
-                    if(nb != nullptr) { nb->prev = a; }
-                    if(pa != nullptr) { pa->next = b; }
-                    if(pb != nullptr) { pb->next = a; } 
+            if (no_threads == 0)
+            {
+                no_threads = std::max(std::size_t(1), std::min(std::size_t(std::thread::hardware_concurrency()), no_arcs/(std::size_t(1) << 20)));
+            }
+            auto chunk = [no_arcs, no_threads](const std::size_t t) { return t*no_arcs/no_threads; };
+
+            // stable counting sort of order by key, every thread counts and scatters one contiguous chunk
+            std::vector<std::vector<IndexType>> count(no_threads);
+            auto sort_pass = [&](const std::vector<IndexType>& order, std::vector<IndexType>& sorted, auto key) {
+                run_parallel(no_threads, [&](const std::size_t t) {
+                    count[t].assign(nodeNum, 0);
+                    for (std::size_t k=chunk(t); k<chunk(t+1); ++k) { count[t][key(order[k])]++; }
+                });
+                IndexType offset = 0;
+                for (NodeId i=0; i<nodeNum; ++i)
+                {
+                    for (std::size_t t=0; t<no_threads; ++t)
+                    {
+                        const IndexType c = count[t][i];
+                        count[t][i] = offset;
+                        offset += c;
+                    }
                 }
+                run_parallel(no_threads, [&](const std::size_t t) {
+                    for (std::size_t k=chunk(t); k<chunk(t+1); ++k) { sorted[count[t][key(order[k])]++] = order[k]; }
+                });
+            };
 
-                if(a_tail != b_tail) {
-                    if(a_tail->firstSaturated == a) { a_tail->firstSaturated = b; }
-                    if(a_tail->firstNonsaturated == a) { a_tail->firstNonsaturated = b; }
-
-                    if(b_tail->firstSaturated == b) { b_tail->firstSaturated = a; }
-                    if(b_tail->firstNonsaturated == b) { b_tail->firstNonsaturated = a; }
-                } else {
-                    if(a_tail->firstSaturated == a) { a_tail->firstSaturated = b; }
-                    else if(b_tail->firstSaturated == b) { a_tail->firstSaturated = a; }
-
-                    if(a_tail->firstNonsaturated == a) { a_tail->firstNonsaturated = b; }
-                    else if(b_tail->firstNonsaturated == b) { a_tail->firstNonsaturated = a; }
-                }
+            // least significant key first: sort by head, then stably by tail
+            std::vector<IndexType> order(no_arcs), sorted(no_arcs);
+            std::iota(order.begin(), order.end(), IndexType(0));
+            sort_pass(order, sorted, head_of);
+            sort_pass(sorted, order, tail_of);
 
-                if(na) { assert(arc_valid(na)); }
-                if(nb) { assert(arc_valid(nb)); }
-                if(pa) { assert(arc_valid(pa)); }
-                if(pb) { assert(arc_valid(pb)); }
-                assert(arc_valid(a) && arc_valid(b) && arc_valid(sa) && arc_valid(sb));
-            }
+            run_parallel(no_threads, [&](const std::size_t t) {
+                for (std::size_t k=chunk(t); k<chunk(t+1); ++k) { sorted[order[k]] = k; }
+            });
+            return sorted;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::order_inter_nodes()
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::order(std::size_t no_threads)
         {
-            for(long e=0; e<2*edgeNum; ++e) { assert(arc_valid(&arcs[e])); }
-
-            std::vector<long> arc_first(nodeNum+1,0);
-            std::vector<long> outgoing_arc_index(nodeNum,0);
-            for(long e=0; e<2*edgeNum; ++e) {
-                arc_first[tail(e)+1]++;
-                outgoing_arc_index[tail(e)]++;
+            SSP_STAT(const auto begin = std::chrono::steady_clock::now();)
+            const std::vector<IndexType> pos = SortArcs(2*edgeNum,
+                    [this](const IndexType a) { return arcs[arcs[a].sister].head; },
+                    [this](const IndexType a) { return arcs[a].head; }, no_threads);
+
+            // move arcs into fresh buffers at their sorted positions
+            Arc* sorted_arcs = (Arc*) malloc(2*edgeNumMax*sizeof(Arc));
+            FlowType* sorted_capacity = (FlowType*) malloc(2*edgeNumMax*sizeof(FlowType));
+            if (edgeNumMax > 0 && (!sorted_arcs || !sorted_capacity))
+            {
+                if(sorted_arcs != nullptr) free(sorted_arcs);
+                if(sorted_capacity != nullptr) free(sorted_capacity);
+                throw std::bad_alloc();
             }
+            for (EdgeId a=0; a<2*edgeNum; ++a)
+            {
+                Arc& b = sorted_arcs[pos[a]];
+                b = arcs[a];
+                b.sister = pos[arcs[a].sister];
+                sorted_capacity[pos[a]] = capacity[a];
+            }
+            if(arcs != nullptr) free(arcs);
+            if(capacity != nullptr) free(capacity);
+            arcs = sorted_arcs;
+            capacity = sorted_capacity;
 
-            std::partial_sum(arc_first.begin(), arc_first.end(), arc_first.begin());
-            std::partial_sum(outgoing_arc_index.begin(), outgoing_arc_index.end(), outgoing_arc_index.begin());
-
-            for(long i=0; i<nodeNum-1; ++i) {
-
-                long last = outgoing_arc_index[i];
-                assert(last < 2*edgeNum);
-
-                for ( long arc_num = arc_first[i]; arc_num < last; arc_num ++ ) {
-                    long tail_node_id = tail(arc_num);
+            // edges that have no entry yet still have their arcs at 2*e, 2*e+1
+            const std::size_t mapped = edgeArc.size();
+            edgeArc.resize(edgeNum);
+            for (EdgeId e=mapped; e<edgeNum; ++e) { edgeArc[e] = 2*e; }
+            for (EdgeId e=0; e<edgeNum; ++e) { edgeArc[e] = pos[edgeArc[e]]; }
 
-                    while ( tail_node_id != i ) {
-                        long arc_new_num = arc_first[tail_node_id];
-                        exchange(&arcs[arc_num], &arcs[arc_new_num]);
+            LinkArcs();
+            SSP_STAT(stats.order_seconds += SecondsSince(begin);)
+        }
 
-                        arc_first[tail_node_id]++;
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::build(const std::vector<NodeId>& tails, const std::vector<NodeId>& heads,
+                const std::vector<FlowType>& lower, const std::vector<FlowType>& upper, const std::vector<CostType>& cost, std::size_t no_threads)
+        {
+            const std::size_t k = tails.size();
+            assert(heads.size() == k && lower.size() == k && upper.size() == k && cost.size() == k);
+            assert(edgeNum == 0 && k <= edgeNumMax);
+
+            // arc 2*e of the input is edge e, arc 2*e+1 its reverse
+            auto tail_of = [&](const IndexType a) { return a & 1 ? heads[a >> 1] : tails[a >> 1]; };
+            auto head_of = [&](const IndexType a) { return a & 1 ? tails[a >> 1] : heads[a >> 1]; };
+            const std::vector<IndexType> pos = SortArcs(2*k, tail_of, head_of, no_threads);
+            if (no_threads == 0)
+            {
+                no_threads = std::max(std::size_t(1), std::min(std::size_t(std::thread::hardware_concurrency()), 2*k/(std::size_t(1) << 20)));
+            }
 
-                        tail_node_id = tail(arc_num);
+            run_parallel(no_threads, [&](const std::size_t t) {
+                for (std::size_t e=t*k/no_threads; e<(t+1)*k/no_threads; ++e)
+                {
+                    assert(tails[e] < nodeNum && heads[e] < nodeNum && tails[e] != heads[e]);
+                    assert(upper[e] >= 0 && lower[e] <= 0 && lower[e] < upper[e]);
+                    Arc* a = &arcs[pos[2*e]];
+                    Arc* a_rev = &arcs[pos[2*e+1]];
+                    a->head = heads[e];
+                    a_rev->head = tails[e];
+                    a->sister = pos[2*e+1];
+                    a_rev->sister = pos[2*e];
+                    a->r_cap = upper[e];
+                    a_rev->r_cap = -lower[e];
+                    a->cost = cost[e];
+                    a_rev->cost = -cost[e];
+                    capacity[pos[2*e]] = upper[e];
+                    capacity[pos[2*e+1]] = lower[e];
+                }
+            });
+            edgeNum = k;
+            edgeArc.resize(k);
+            for (EdgeId e=0; e<k; ++e) { edgeArc[e] = pos[2*e]; }
+
+            // as in add_edge, arcs with negative reduced cost are saturated. This happens before linking,
+            // so that arc lists come out in the same order as after add_edge and order()
+            for (EdgeId e=0; e<2*k; ++e)
+            {
+                Arc* a = &arcs[pos[e]];
+                if (a->r_cap > 0 && GetRCost(a) < 0)
+                {
+                    const FlowType delta = a->r_cap;
+                    a->r_cap = 0;
+                    Sister(a)->r_cap += delta;
+                    Node* j = Head(a);
+                    j->excess += delta;
+                    Tail(a)->excess -= delta;
+                    mcf_cost += delta*a->cost;
+                    if (j->excess > 0 && j->next == none)
+                    {
+                        j->next = firstActive;
+                        firstActive = a->head;
                     }
+                    SSP_STAT(stats.presaturated_arcs++;)
                 }
             }
+            LinkArcs();
         }
 
-    template <typename FlowType, typename CostType> 
-        inline void SSP<FlowType, CostType>::order_intra_nodes()
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::solve()
         {
-            // sort outgoing arcs of every node by head node id. This assumes that order_inter_nodes has already been called
-            std::vector<long> perm(nodeNum);
-            std::vector<long> outgoing_arc_begin(nodeNum+1, 0);
-            for(EdgeId e=0; e<2*edgeNum; ++e) {
-                outgoing_arc_begin[tail(e)+1]++;
-            }
-            std::partial_sum(outgoing_arc_begin.begin(), outgoing_arc_begin.end(), outgoing_arc_begin.begin());
-
-            for(NodeId i=0; i<nodeNum; ++i) {
-                const long no_nodes = outgoing_arc_begin[i+1] - outgoing_arc_begin[i];
-                std::iota(perm.begin(), perm.begin() + no_nodes, 0);
-                Arc* arc = arcs + outgoing_arc_begin[i];
-                Node* n = nodes;
+            assert( 0 == std::accumulate(nodes, nodes+no_nodes(), 0, [](const long int s, const Node& i) { return s + i.excess; }) );
+            Init();
+            ProcessActive();
 
-                auto sort_func = [arc,n](auto i, auto j) { 
-                    assert(arc[i].sister->head == arc[j].sister->head);
-                    return arc[i].head - n < arc[j].head - n; 
-                };
-                std::sort(perm.begin(), perm.begin()+no_nodes, sort_func);
+            assert(TestCosts());
+            assert(TestOptimality());
 
-                // follow cycles in permutation.
-                for(long c=0; c<no_nodes; ++c) {
-                    long next_idx = perm[c];
-                    if(next_idx == c || next_idx < 0) {
-                        continue;
-                    }
-                    long cur_idx = c;
-                    while(perm[next_idx] >= 0) {
-                        exchange(&arc[cur_idx], &arc[next_idx]); 
-                        perm[cur_idx] -= no_nodes; // mark as visited
-                        cur_idx = next_idx;
-                        next_idx = perm[next_idx];
-                    }
-                }
-                assert(std::is_sorted(arc, arc+no_nodes, [](auto& a, auto& b) { return a.head < b.head; }));
-            } 
+            for(EdgeId e=0; e<2*edgeNum; ++e) { assert(arc_valid(&arcs[e])); }
+            return mcf_cost;
         }
 
-    template <typename FlowType, typename CostType> 
-        inline CostType SSP<FlowType, CostType>::solve()
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::resolve()
         {
             assert( 0 == std::accumulate(nodes, nodes+no_nodes(), 0, [](const long int s, const Node& i) { return s + i.excess; }) );
+            ProcessActive();
+
+            assert(TestCosts());
+            assert(TestOptimality());
+            return mcf_cost;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::ProcessActive()
+        {
+            SSP_STAT(const auto begin = std::chrono::steady_clock::now();)
             Node* i;
-            Init();
             while ( 1 )
             {
-                i = firstActive;
-                if (i == &nodes[nodeNum]) break;
+                if (firstActive == nodeNum) break;
+                i = nodes + firstActive;
                 firstActive = i->next;
-                i->next = NULL;
+                i->next = none;
                 if (i->excess > 0)
                 {
                     Dijkstra(i);
-                    if (i->excess > 0 && !i->next) 
+                    if (i->excess > 0 && i->next == none) 
                     { 
                         i->next = firstActive; 
-                        firstActive = i; 
+                        firstActive = i - nodes; 
                     }
                 }
             }
-
-            assert(TestCosts());
-            assert(TestOptimality());
-
-            for(EdgeId e=0; e<2*edgeNum; ++e) { assert(arc_valid(&arcs[e])); }
-            return mcf_cost;
+            SSP_STAT(stats.main_loop_seconds += SecondsSince(begin);)
         }
 
-    template <typename FlowType, typename CostType> 
-        inline CostType SSP<FlowType, CostType>::objective() const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::solve_capacity_scaling()
         {
-            CostType c = 0.0;
-            for(EdgeId a=0; a<2*edgeNum; ++a) {
-                c += flow(a)*(arcs[a].cost);
+            FlowType max_excess = 0;
+            for (Node* i=nodes; i<nodes+nodeNum; i++) { max_excess = std::max(max_excess, i->excess); }
+            FlowType delta = 1;
+            while (delta <= max_excess/2) delta *= 2;
+
+            SSP_STAT(const auto begin = std::chrono::steady_clock::now();)
+            for (; delta > 1; delta /= 2)
+            {
+                // restore non-negative reduced costs on the delta-residual network
+                for (Arc* a=arcs; a<arcs+2*edgeNum; a++)
+                {
+                    if (a->r_cap >= delta && GetRCost(a) < 0) PushFlow(a, a->r_cap);
+                }
+
+                // deficits only shrink during a phase, hence stop searching as soon as none of size delta is left
+                auto deficit_left = [this,delta]() { return std::any_of(nodes, nodes+nodeNum, [delta](const Node& i) { return i.excess <= -delta; }); };
+                for (Node* i=nodes; i<nodes+nodeNum && deficit_left(); i++)
+                {
+                    while (i->excess >= delta && Dijkstra(i, delta) && deficit_left()) {}
+                }
             }
-            return c/2.0;
+            SSP_STAT(stats.main_loop_seconds += SecondsSince(begin);)
+
+            // phase delta = 1 is the ordinary algorithm
+            return solve();
         }
 
-    template <typename FlowType, typename CostType> 
-        bool SSP<FlowType, CostType>::TestOptimality() const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline bool SSP<FlowType, CostType, PriorityQueue, IndexType>::DijkstraMultiSource()
         {
             Node* i;
+            Node* j;
             Arc* a;
+            CostType d;
+            Node* permanentNodes;
 
+            IndexType FLAG0 = NextFlag(); // permanently labeled nodes
+            IndexType FLAG1 = NextFlag(); // temporarily labeled nodes
+
+            queue.Reset();
+            bool active = false;
             for (i=nodes; i<nodes+nodeNum; i++)
             {
-                if (i->excess != 0)
+                if (i->excess > 0)
                 {
-                    return false;
+                    i->parent = none;
+                    i->flag = FLAG1;
+                    queue.Add(i, 0);
+                    SSP_STAT(stats.heap_adds++;)
+                    active = true;
                 }
-                for (a=i->firstSaturated; a; a=a->next)
+            }
+            if (!active) return false;
+            SSP_STAT(BeginIteration(nodeNum);)
+
+            permanentNodes = nullptr;
+
+            while ( (i=queue.RemoveMin(d)) )
+            {
+                SSP_STAT(stats.heap_remove_mins++;)
+                if (i->excess < 0)
                 {
-                    if (a->r_cap != 0)
+                    for (j=permanentNodes; j; j=NodePtr(j->next_permanent)) j->pi += d;
+
+                    // augment along the shortest path found, so that every phase makes progress
+                    Node* start = i;
+                    CostType path_cost = 0;
+                    for (a=ArcPtr(i->parent); a; a=ArcPtr(Tail(a)->parent))
                     {
-                        return false;
+                        path_cost += a->cost;
+                        start = Tail(a);
                     }
+                    FlowType delta = Augment(start, i);
+                    mcf_cost += delta*path_cost;
+                    return true;
                 }
-                for (a=i->firstNonsaturated; a; a=a->next)
+
+                i->pi -= d;
+                i->flag = FLAG0;
+                i->next_permanent = Index(permanentNodes);
+                permanentNodes = i;
+                SSP_STAT(iteration.nodes_settled++;)
+
+                for (IndexType a_idx=i->firstNonsaturated; a_idx!=none; a_idx=a->next)
                 {
-                    CostType c = a->GetRCost();
-                    if (a->r_cap <= 0 || a->GetRCost() < -1e-5)
+                    a = arcs + a_idx;
+                    SSP_STAT(iteration.arcs_relaxed++;)
+                    j = Head(a);
+                    if (j->flag == FLAG0) continue;
+                    d = a->cost + j->pi - i->pi;
+                    if (j->flag == FLAG1)
                     {
-                        return false;
+                        if (d >= queue.GetKey(j)) continue;
+                        queue.DecreaseKey(j, d);
+                        SSP_STAT(stats.heap_decrease_keys++;)
                     }
+                    else
+                    {
+                        queue.Add(j, d);
+                        SSP_STAT(stats.heap_adds++;)
+                        j->flag = FLAG1;
+                    }
+                    j->parent = a_idx;
                 }
             }
-            return true;
+
+            SSP_STAT(EndIteration();)
+            throw std::runtime_error("MCF::SSP: problem infeasible, excess cannot be routed to any deficit");
         }
 
-    template <typename FlowType, typename CostType> 
-        bool SSP<FlowType, CostType>::TestCosts() const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::BlockingFlow()
         {
-            CostType _cost = 0;
+            const IndexType SEEN = NextFlag(); // current arc initialized
+            const IndexType PATH = NextFlag(); // on current search path
+            const IndexType DEAD = NextFlag(); // no deficit reachable via admissible arcs
 
-            for (Arc* a=arcs; a<arcs+2*edgeNum; ++a)
+            for (Node* s=nodes; s<nodes+nodeNum; s++)
             {
-                if(a->r_cap + a->sister->r_cap != capacity[a-arcs] + capacity[a->sister-arcs]) {
-                    return false;
+                if (s->excess <= 0 || s->flag == DEAD) continue;
+                if (s->flag != SEEN) s->current = s->firstNonsaturated;
+                s->flag = PATH;
+                s->parent = none;
+
+                Node* i = s;
+                while ( 1 )
+                {
+                    if (i->excess < 0)
+                    {
+                        FlowType delta = (s->excess < -i->excess) ? s->excess : -i->excess;
+                        Arc* a;
+                        SSP_STAT(std::size_t path_arcs = 0;)
+                        for (a=ArcPtr(i->parent); a; a=ArcPtr(Tail(a)->parent))
+                        {
+                            if (delta > a->r_cap) delta = a->r_cap;
+                            SSP_STAT(path_arcs++;)
+                        }
+                        SSP_STAT(RecordAugmentation(path_arcs, delta);)
+
+                        i->excess += delta;
+                        s->excess -= delta;
+                        i->flag = SEEN;
+                        for (a=ArcPtr(i->parent); a; a=ArcPtr(Tail(a)->parent))
+                        {
+                            Node* tail = Tail(a);
+                            // arcs behind the current one are not moved by augmenting, so its successor stays valid
+                            Arc* next = ArcPtr(a->next);
+                            DecreaseRCap(a, delta);
+                            IncreaseRCap(Sister(a), delta);
+                            if (a->r_cap == 0) tail->current = Index(next);
+                            mcf_cost += delta*a->cost;
+                            tail->flag = SEEN;
+                        }
+
+                        if (s->excess == 0) break;
+                        s->flag = PATH;
+                        i = s;
+                        continue;
+                    }
+
+                    // advance along an admissible arc or retreat
+                    Arc* a;
+                    for (a=ArcPtr(i->current); a; a=ArcPtr(a->next))
+                    {
+                        Node* j = Head(a);
+                        if (j->flag == PATH || j->flag == DEAD) continue;
+                        if (GetRCost(a) == 0) break;
+                    }
+                    i->current = Index(a);
+                    if (a)
+                    {
+                        Node* j = Head(a);
+                        if (j->flag != SEEN) j->current = j->firstNonsaturated;
+                        j->flag = PATH;
+                        j->parent = Index(a);
+                        i = j;
+                    }
+                    else
+                    {
+                        i->flag = DEAD;
+                        if (i == s) break;
+                        i = Tail(&arcs[i->parent]);
+                    }
                 }
             }
+        }
 
-            if(std::abs(objective() - mcf_cost)/no_edges() > 1e-8) {
-                return false;
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::solve_primal_dual()
+        {
+            Init();
+            SSP_STAT(const auto begin = std::chrono::steady_clock::now();)
+            while ( DijkstraMultiSource() )
+            {
+                BlockingFlow();
+                SSP_STAT(EndIteration();)
             }
+            SSP_STAT(stats.main_loop_seconds += SecondsSince(begin);)
+            // all positive excess has been routed, so the deficits left exceed the supply
+            if (std::any_of(nodes, nodes+nodeNum, [](const Node& i) { return i.excess < 0; }))
+            { throw std::runtime_error("MCF::SSP: problem infeasible, deficit left after routing all excess"); }
 
-            return true;
+            // nodes are not taken from the active list here, empty it as solve() would
+            for (Node* i=nodes; i<nodes+nodeNum; i++) i->next = none;
+            firstActive = nodeNum;
+
+            assert(TestCosts());
+            assert(TestOptimality());
+
+            for(EdgeId e=0; e<2*edgeNum; ++e) { assert(arc_valid(&arcs[e])); }
+            return mcf_cost;
         }
 
-    template<typename FlowType, typename CostType>
-        void SSP<FlowType, CostType>::print_flow() const
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::BuildCSR()
         {
-            std::cout << "flow:\n";
+            // counting sort of arcs by tail node
+            csr.first.assign(nodeNum+1, 0);
+            for(EdgeId e=0; e<2*edgeNum; ++e) { csr.first[tail(e)+1]++; }
+            std::partial_sum(csr.first.begin(), csr.first.end(), csr.first.begin());
+
+            csr.head.resize(2*edgeNum);
+            csr.r_cap.resize(2*edgeNum);
+            csr.cost.resize(2*edgeNum);
+            csr.sister.resize(2*edgeNum);
+            csr.arc.resize(2*edgeNum);
+            csr.parent.resize(nodeNum);
+
+            std::vector<EdgeId> pos(csr.first.begin(), csr.first.end()-1);
+            std::vector<EdgeId> csr_pos(2*edgeNum);
             for(EdgeId e=0; e<2*edgeNum; ++e) {
-                std::cout << tail(e) << " -> " << head(e) << ": flow = " << flow(e) << ", capacity = " << capacity[e] << ", cost = " << arcs[e].cost << "\n";
+                const EdgeId p = pos[tail(e)]++;
+                csr_pos[e] = p;
+                csr.arc[p] = e;
+                csr.head[p] = head(e);
+                csr.r_cap[p] = arcs[e].r_cap;
+                csr.cost[p] = arcs[e].cost;
+            }
+            for(EdgeId p=0; p<2*edgeNum; ++p) {
+                csr.sister[p] = csr_pos[arcs[csr.arc[p]].sister];
             }
         }
 
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::WriteBackCSR()
+        {
+            for(EdgeId p=0; p<2*edgeNum; ++p) {
+                arcs[csr.arc[p]].r_cap = csr.r_cap[p];
+            }
+            LinkArcs();
+        }
 
-    // read file in DIMACS format
-    template<typename FLOW_TYPE, typename COST_TYPE>
-        SSP<FLOW_TYPE,COST_TYPE>* read_dimacs_file(const std::string& filename)
-        {
-            SSP<FLOW_TYPE,COST_TYPE>* f = nullptr;
-
-            std::ifstream instance;
-            instance.open(filename);
-            if(!instance.is_open()) {
-                throw std::runtime_error("could not open file " + filename);
-            }
-            std::string line;
-            while(std::getline(instance, line))
-            {
-                // DIMACS format:
-                // c arc has <tail> <head> <capacity l.b.> <capacity u.b> <cost>
-                if(line.empty()) continue;
-                std::istringstream iss(line);
-                char id;
-                if (!(iss >> id )) { throw std::runtime_error("in file " + filename + ": cannot read line " + line); } 
-                switch(id) {
-                    case 'c':
-                        break;
-                    case 'p': 
-                        {
-                            if(f != nullptr) { throw std::runtime_error("in file " + filename + ": not more than one line beginning with 'p' allowed"); }
-                            std::string min;
-                            std::size_t n; // number of nodes
-                            std::size_t m; // number of arcs
-                            if( !(iss >> min >> n >> m)) { throw std::runtime_error("in file " + filename + ": cannot read number of nodes and arcs from line:\n " + line); } 
-                            if("min" != min) { throw std::runtime_error("in file " + filename + ": min must come after 'p' in line:\n " + line); } 
-                            f = new SSP<FLOW_TYPE,COST_TYPE>(n,m);
-                            break;
-                        }
-                    case 'n': 
-                        {
-                            std::size_t id, flow;
-                            if( !(iss >> id >> flow)) { throw std::runtime_error("in file " + filename + ": cannot read number node id and external flow from line:\n " + line); } 
-                            assert(id >= 1);
-                            f->add_node_excess(id-1,flow);
-                            break;
-                        }
-                    case 'a': 
-                        {
-                            long i,j,lower,upper,cost;
-                            if( !(iss >> i >> j >> lower >> upper >> cost)) { throw std::runtime_error("in file " + filename + ": cannot read arc information from line:\n " + line); } 
-                            assert(i >= 1);
-                            assert(j >= 1);
-                            f->add_edge(i-1,j-1,lower,upper,cost);
-                            break;
-                        }
-                    default:
-                        throw std::runtime_error("in file " + filename + ": unknown line identifier " + std::to_string(id));
-                        break;
-                }
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::LinkArcs()
+        {
+            for(Node* i=nodes; i<nodes+nodeNum; ++i) {
+                i->firstNonsaturated = none;
+                i->firstSaturated = none;
+            }
+            // insert in reverse so that lists are ordered by arc index
+            for(EdgeId e=2*edgeNum; e-- > 0; ) {
+                Arc* a = &arcs[e];
+                Node* i = Tail(a);
+                IndexType& first = a->r_cap > 0 ? i->firstNonsaturated : i->firstSaturated;
+                a->prev = none;
+                a->next = first;
+                if(first != none) arcs[first].prev = e;
+                first = e;
             }
-            if(f == nullptr) { throw std::runtime_error("Exactly one line beginning with 'p' allowed in file " + filename); }
-            return f; 
         }
 
-} // namespace MCF
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline FlowType SSP<FlowType, CostType, PriorityQueue, IndexType>::AugmentCSR(Node* start, Node* end)
+        {
+            FlowType delta = (start->excess < -end->excess) ? start->excess : -end->excess;
+            const NodeId s = start - nodes;
+            SSP_STAT(std::size_t path_arcs = 0;)
+
+            for (NodeId i=end-nodes; i!=s; i=csr.head[csr.sister[csr.parent[i]]])
+            {
+                const EdgeId a = csr.parent[i];
+                if (delta > csr.r_cap[a]) delta = csr.r_cap[a];
+                SSP_STAT(path_arcs++;)
+            }
+            assert(delta > 0);
+            SSP_STAT(RecordAugmentation(path_arcs, delta);)
+
+            end->excess += delta;
+            for (NodeId i=end-nodes; i!=s; )
+            {
+                const EdgeId a = csr.parent[i];
+                const EdgeId b = csr.sister[a];
+                csr.r_cap[a] -= delta;
+                csr.r_cap[b] += delta;
+                i = csr.head[b];
+            }
+            start->excess -= delta;
+
+            return delta;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::DijkstraCSR(Node* start)
+        {
+            assert(start->excess > 0);
+
+            Node* i;
+            Node* j;
+            CostType d;
+            Node* permanentNodes;
+
+            IndexType FLAG0 = NextFlag(); // permanently labeled nodes
+            IndexType FLAG1 = NextFlag(); // temporarily labeled nodes
+
+            SSP_STAT(BeginIteration(start - nodes);)
+            start->flag = FLAG1;
+            queue.Reset();
+            queue.Add(start, 0);
+            SSP_STAT(stats.heap_adds++;)
+
+            permanentNodes = nullptr;
+
+            while ( (i=queue.RemoveMin(d)) )
+            {
+                SSP_STAT(stats.heap_remove_mins++;)
+                if (i->excess < 0)
+                {
+                    FlowType delta = AugmentCSR(start, i);
+                    mcf_cost += delta*(d - i->pi + start->pi);
+                    for (i=permanentNodes; i; i=NodePtr(i->next_permanent)) i->pi += d;
+                    break;
+                }
+
+                i->pi -= d;
+                i->flag = FLAG0;
+                i->next_permanent = Index(permanentNodes);
+                permanentNodes = i;
+                SSP_STAT(iteration.nodes_settled++;)
+
+                const NodeId i_id = i - nodes;
+                const EdgeId last = csr.first[i_id+1];
+                for (EdgeId a=csr.first[i_id]; a<last; ++a)
+                {
+                    if (csr.r_cap[a] == 0) continue;
+                    SSP_STAT(iteration.arcs_relaxed++;)
+                    j = nodes + csr.head[a];
+                    if (j->flag == FLAG0) continue;
+                    d = csr.cost[a] + j->pi - i->pi;
+                    if (j->flag == FLAG1)
+                    {
+                        if (d >= queue.GetKey(j)) continue;
+                        queue.DecreaseKey(j, d);
+                        SSP_STAT(stats.heap_decrease_keys++;)
+                    }
+                    else
+                    {
+                        queue.Add(j, d);
+                        SSP_STAT(stats.heap_adds++;)
+                        j->flag = FLAG1;
+                    }
+                    csr.parent[j-nodes] = a;
+                }
+            }
+            SSP_STAT(EndIteration();)
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::solve_csr()
+        {
+            assert( 0 == std::accumulate(nodes, nodes+no_nodes(), 0, [](const long int s, const Node& i) { return s + i.excess; }) );
+            Node* i;
+            Init();
+            SSP_STAT(const auto begin = std::chrono::steady_clock::now();)
+            BuildCSR();
+            while ( 1 )
+            {
+                if (firstActive == nodeNum) break;
+                i = nodes + firstActive;
+                firstActive = i->next;
+                i->next = none;
+                if (i->excess > 0)
+                {
+                    DijkstraCSR(i);
+                    if (i->excess > 0 && i->next == none) 
+                    { 
+                        i->next = firstActive; 
+                        firstActive = i - nodes; 
+                    }
+                }
+            }
+            WriteBackCSR();
+            SSP_STAT(stats.main_loop_seconds += SecondsSince(begin);)
+
+            assert(TestCosts());
+            assert(TestOptimality());
+
+            for(EdgeId e=0; e<2*edgeNum; ++e) { assert(arc_valid(&arcs[e])); }
+            return mcf_cost;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::Refine(const CostType epsilon, std::vector<CostType>& pi, std::vector<FlowType>& excess)
+        {
+            const IndexType* const first = csr.first.data();
+            const IndexType* const head = csr.head.data();
+            const IndexType* const sister = csr.sister.data();
+            const CostType* const cost = csr.cost.data();
+            FlowType* const r_cap = csr.r_cap.data();
+
+            SSP_STAT(stats.refine_phases++;)
+            // saturate arcs with negative reduced cost, afterwards the pseudoflow is 0-optimal
+            for (NodeId i=0; i<nodeNum; ++i)
+            {
+                for (IndexType p=first[i]; p<first[i+1]; ++p)
+                {
+                    if (r_cap[p] > 0 && cost[p] + pi[head[p]] - pi[i] < 0)
+                    {
+                        const FlowType delta = r_cap[p];
+                        r_cap[p] = 0;
+                        r_cap[sister[p]] += delta;
+                        excess[i] -= delta;
+                        excess[head[p]] += delta;
+                    }
+                }
+            }
+
+            // discharge active nodes in FIFO order. Admissible arcs have positive residual capacity and negative reduced cost
+            PriceUpdate(epsilon, pi, excess);
+            std::vector<IndexType> current(csr.first.begin(), csr.first.end()-1);
+            // a node is queued when it becomes active and discharged completely, hence it is contained at most once
+            std::deque<IndexType> queue;
+            std::size_t relabels = 0;
+            for (NodeId i=0; i<nodeNum; ++i) { if (excess[i] > 0) queue.push_back(i); }
+            while (!queue.empty())
+            {
+                const IndexType i = queue.front();
+                queue.pop_front();
+                while (excess[i] > 0)
+                {
+                    IndexType p = current[i];
+                    for (; p<first[i+1]; ++p)
+                    {
+                        if (r_cap[p] > 0 && cost[p] + pi[head[p]] - pi[i] < 0)
+                        {
+                            const IndexType j = head[p];
+                            const FlowType delta = std::min(excess[i], r_cap[p]);
+                            r_cap[p] -= delta;
+                            r_cap[sister[p]] += delta;
+                            excess[i] -= delta;
+                            if (excess[j] <= 0 && excess[j] + delta > 0) queue.push_back(j);
+                            excess[j] += delta;
+                            if (excess[i] == 0) break;
+                        }
+                    }
+                    current[i] = p;
+                    if (excess[i] == 0) break;
+
+                    // relabel: the cheapest residual arc becomes admissible
+                    CostType min_pi = std::numeric_limits<CostType>::max();
+                    for (IndexType p=first[i]; p<first[i+1]; ++p)
+                    {
+                        if (r_cap[p] > 0) min_pi = std::min(min_pi, cost[p] + pi[head[p]]);
+                    }
+                    assert(min_pi < std::numeric_limits<CostType>::max()); // excess cannot leave, problem is infeasible
+                    pi[i] = min_pi + epsilon;
+                    current[i] = first[i];
+                    if (++relabels == nodeNum)
+                    {
+                        PriceUpdate(epsilon, pi, excess);
+                        std::copy(csr.first.begin(), csr.first.end()-1, current.begin());
+                        relabels = 0;
+                    }
+                }
+            }
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline void SSP<FlowType, CostType, PriorityQueue, IndexType>::PriceUpdate(const CostType epsilon, std::vector<CostType>& pi, const std::vector<FlowType>& excess)
+        {
+            // backward search from deficit nodes with Dial's buckets. A residual arc with reduced cost c has length
+            // floor(c/epsilon)+1, or 0 if c < 0. Distances are capped at nodeNum, the search stops once all
+            // active nodes are reached and the remaining nodes keep the distance of the last bucket.
+            const IndexType unreached = std::numeric_limits<IndexType>::max();
+            std::vector<IndexType> dist(nodeNum, unreached);
+            std::vector<std::vector<IndexType>> buckets(nodeNum+1);
+            std::size_t no_active = 0;
+            for (NodeId i=0; i<nodeNum; ++i)
+            {
+                if (excess[i] < 0) { dist[i] = 0; buckets[0].push_back(i); }
+                else if (excess[i] > 0) ++no_active;
+            }
+            std::vector<bool> scanned(nodeNum, false);
+            std::size_t level = 0;
+            for (; level<=nodeNum && no_active>0; ++level)
+            {
+                for (std::size_t k=0; k<buckets[level].size() && no_active>0; ++k)
+                {
+                    const IndexType w = buckets[level][k];
+                    if (scanned[w] || dist[w] != level) continue;
+                    scanned[w] = true;
+                    if (excess[w] > 0) --no_active;
+                    for (IndexType p=csr.first[w]; p<csr.first[w+1]; ++p)
+                    {
+                        // residual arc v->w is the sister of w->v
+                        const IndexType s = csr.sister[p];
+                        const IndexType v = csr.head[p];
+                        if (csr.r_cap[s] == 0 || scanned[v]) continue;
+                        const CostType c = csr.cost[s] + pi[w] - pi[v];
+                        const CostType length = c < 0 ? CostType(0) : FloorDiv(c, epsilon, std::is_integral<CostType>()) + 1;
+                        if (length > CostType(nodeNum - level)) continue;
+                        const IndexType d = IndexType(level + std::size_t(length));
+                        if (d < dist[v]) { dist[v] = d; buckets[d].push_back(v); }
+                    }
+                }
+                if (no_active == 0) break;
+            }
+            level = std::min(level, std::size_t(nodeNum));
+            for (NodeId i=0; i<nodeNum; ++i)
+            {
+                pi[i] += epsilon*CostType(std::min(std::size_t(dist[i]), level));
+            }
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline bool SSP<FlowType, CostType, PriorityQueue, IndexType>::RepairPotentials(std::vector<CostType>& pi) const
+        {
+            // lowering pi[i] can only violate residual arcs into i, their tails are queued again
+            std::deque<IndexType> queue(nodeNum);
+            std::iota(queue.begin(), queue.end(), IndexType(0));
+            std::vector<bool> queued(nodeNum, true);
+            std::vector<std::size_t> no_lowered(nodeNum, 0);
+            while (!queue.empty())
+            {
+                const IndexType i = queue.front();
+                queue.pop_front();
+                queued[i] = false;
+                bool lowered = false;
+                for (IndexType p=csr.first[i]; p<csr.first[i+1]; ++p)
+                {
+                    const CostType c = arcs[csr.arc[p]].cost + pi[csr.head[p]];
+                    if (csr.r_cap[p] > 0 && c < pi[i]) { pi[i] = c; lowered = true; }
+                }
+                if (!lowered) continue;
+                if (++no_lowered[i] > nodeNum) return false;
+                for (IndexType p=csr.first[i]; p<csr.first[i+1]; ++p)
+                {
+                    const IndexType j = csr.head[p];
+                    if (csr.r_cap[csr.sister[p]] > 0 && !queued[j]) { queue.push_back(j); queued[j] = true; }
+                }
+            }
+            return true;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::solve_cost_scaling(const CostType alpha)
+        {
+            assert(alpha > 1);
+            assert( 0 == std::accumulate(nodes, nodes+no_nodes(), 0, [](const long int s, const Node& i) { return s + i.excess; }) );
+            SSP_STAT(const auto begin = std::chrono::steady_clock::now();)
+            BuildCSR();
+
+            // costs are scaled by a power of two, so that dividing floating point potentials by it is exact
+            CostType scale = 1;
+            while (scale < CostType(nodeNum + 1)) scale *= 2;
+            std::vector<CostType> pi(nodeNum);
+            std::vector<FlowType> excess(nodeNum);
+            bool feasible = true;
+            for (NodeId i=0; i<nodeNum; ++i)
+            {
+                pi[i] = scale*nodes[i].pi;
+                excess[i] = nodes[i].excess;
+                feasible = feasible && excess[i] == 0;
+            }
+
+            // a feasible flow is kept and epsilon starts at its largest violation of optimality, otherwise at the largest cost
+            CostType epsilon = 1;
+            for (NodeId i=0; i<nodeNum; ++i)
+            {
+                for (IndexType p=csr.first[i]; p<csr.first[i+1]; ++p)
+                {
+                    csr.cost[p] *= scale;
+                    if (csr.r_cap[p] > 0) epsilon = std::max(epsilon, -(csr.cost[p] + pi[csr.head[p]] - pi[i]));
+                }
+            }
+            if (!feasible)
+            {
+                for (EdgeId p=0; p<2*edgeNum; ++p) { epsilon = std::max(epsilon, std::abs(csr.cost[p])); }
+            }
+
+            do
+            {
+                epsilon = std::max(CostType(1), epsilon/alpha);
+                Refine(epsilon, pi, excess);
+            } while (epsilon > 1);
+
+            // epsilon = 1 on costs scaled by more than no_nodes() means the flow is optimal
+            // every change of flow is counted on an arc and on its sister
+            CostType delta_cost = 0;
+            for (EdgeId p=0; p<2*edgeNum; ++p)
+            {
+                const Arc& a = arcs[csr.arc[p]];
+                delta_cost += (a.r_cap - csr.r_cap[p])*a.cost;
+            }
+            mcf_cost += delta_cost/2;
+            for (NodeId i=0; i<nodeNum; ++i)
+            {
+                assert(excess[i] == 0);
+                nodes[i].excess = excess[i];
+                nodes[i].next = none;
+            }
+            firstActive = nodeNum;
+            if (std::is_integral<CostType>::value)
+            {
+                // floor(pi/scale) violates optimality by at most one
+                for (NodeId i=0; i<nodeNum; ++i) { pi[i] = FloorDiv(pi[i], scale, std::is_integral<CostType>()); }
+                const bool repaired = RepairPotentials(pi);
+                assert(repaired);
+                (void)repaired;
+            }
+            else
+            {
+                // exact for costs with integer values, otherwise the flow need not be optimal yet and the scaled potentials are kept
+                for (NodeId i=0; i<nodeNum; ++i) { pi[i] /= scale; }
+                std::vector<CostType> repaired(pi);
+                if (RepairPotentials(repaired)) pi.swap(repaired);
+            }
+            for (NodeId i=0; i<nodeNum; ++i) { nodes[i].pi = pi[i]; }
+            WriteBackCSR();
+            SSP_STAT(stats.main_loop_seconds += SecondsSince(begin);)
+
+            // remaining violations with floating point costs are repaired by the successive shortest path algorithm
+            if (!std::is_integral<CostType>::value) return solve();
+
+            assert(TestCosts());
+            assert(TestOptimality());
+            return mcf_cost;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::solve(const Algorithm algorithm)
+        {
+            switch (algorithm)
+            {
+                case Algorithm::successive_shortest_path: return solve();
+                case Algorithm::successive_shortest_path_csr: return solve_csr();
+                case Algorithm::capacity_scaling: return solve_capacity_scaling();
+                case Algorithm::primal_dual: return solve_primal_dual();
+                case Algorithm::cost_scaling: return solve_cost_scaling();
+            }
+            throw std::invalid_argument("MCF::SSP: unknown algorithm");
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline CostType SSP<FlowType, CostType, PriorityQueue, IndexType>::objective() const
+        {
+            CostType c = 0.0;
+            for(EdgeId a=0; a<2*edgeNum; ++a) {
+                c += flow(a)*(arcs[a].cost);
+            }
+            return c/2.0;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        inline std::size_t SSP<FlowType, CostType, PriorityQueue, IndexType>::memory_footprint() const
+        {
+            std::size_t bytes = nodeNumMax*sizeof(Node) + 2*edgeNumMax*(sizeof(Arc) + sizeof(FlowType)) + edgeArc.capacity()*sizeof(IndexType);
+            bytes += (csr.first.capacity() + csr.head.capacity() + csr.sister.capacity() + csr.arc.capacity() + csr.parent.capacity())*sizeof(IndexType);
+            bytes += csr.r_cap.capacity()*sizeof(FlowType) + csr.cost.capacity()*sizeof(CostType);
+            return bytes;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        bool SSP<FlowType, CostType, PriorityQueue, IndexType>::TestOptimality() const
+        {
+            Node* i;
+            Arc* a;
+
+            for (i=nodes; i<nodes+nodeNum; i++)
+            {
+                if (i->excess != 0)
+                {
+                    return false;
+                }
+                for (a=ArcPtr(i->firstSaturated); a; a=ArcPtr(a->next))
+                {
+                    if (a->r_cap != 0)
+                    {
+                        return false;
+                    }
+                }
+                for (a=ArcPtr(i->firstNonsaturated); a; a=ArcPtr(a->next))
+                {
+                    CostType c = GetRCost(a);
+                    if (a->r_cap <= 0 || GetRCost(a) < -1e-5)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType> 
+        bool SSP<FlowType, CostType, PriorityQueue, IndexType>::TestCosts() const
+        {
+            CostType _cost = 0;
+
+            for (Arc* a=arcs; a<arcs+2*edgeNum; ++a)
+            {
+                if(a->r_cap + Sister(a)->r_cap != capacity[a-arcs] + capacity[a->sister]) {
+                    return false;
+                }
+            }
+
+            if(std::abs(objective() - mcf_cost)/no_edges() > 1e-8) {
+                return false;
+            }
+
+            return true;
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType>
+        void SSP<FlowType, CostType, PriorityQueue, IndexType>::print_flow() const
+        {
+            std::cout << "flow:\n";
+            for(EdgeId e=0; e<2*edgeNum; ++e) {
+                std::cout << tail(e) << " -> " << head(e) << ": flow = " << flow(e) << ", capacity = " << capacity[e] << ", cost = " << arcs[e].cost << "\n";
+            }
+        }
+
+
+    /////////////////////////////////////////////////////////////////////////
+    // Reading files in DIMACS format:
+    // c <comment>
+    // p min <nodes> <arcs>
+    // n <node id> <external flow>
+    // a <tail> <head> <capacity l.b.> <capacity u.b> <cost>
+    /////////////////////////////////////////////////////////////////////////
+
+    // read-only view of a whole file. Memory mapped where available.
+    class MappedFile
+    {
+        public:
+            MappedFile(const std::string& filename);
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            ~MappedFile();
+            const char* begin() const { return data; }
+            const char* end() const { return data + size; }
+
+        private:
+            const char* data = nullptr;
+            std::size_t size = 0;
+            bool mapped = false;
+            std::string buffer;
+    };
+
+    inline MappedFile::MappedFile(const std::string& filename)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if(fd < 0) { throw std::runtime_error("could not open file " + filename); }
+        struct stat st;
+        if(fstat(fd, &st) != 0) { close(fd); throw std::runtime_error("could not stat file " + filename); }
+        size = st.st_size;
+        if(size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p != MAP_FAILED) {
+                madvise(p, size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(p);
+                mapped = true;
+            }
+        }
+        close(fd);
+        if(mapped || size == 0) { return; }
+#endif
+        std::ifstream instance(filename, std::ios::binary);
+        if(!instance.is_open()) { throw std::runtime_error("could not open file " + filename); }
+        buffer.assign(std::istreambuf_iterator<char>(instance), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    inline MappedFile::~MappedFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if(mapped) { munmap(const_cast<char*>(data), size); }
+#endif
+    }
+
+    // scanner for whitespace separated numbers within one line of a DIMACS file
+    class DimacsScanner
+    {
+        public:
+            DimacsScanner(const char* _p, const char* _end) : p(_p), end(_end) {}
+
+            void SkipBlank() { while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p; }
+            bool AtLineEnd() { SkipBlank(); return p == end || *p == '\n'; }
+            void SkipLine() { p = static_cast<const char*>(std::memchr(p, '\n', end-p)); p = p ? p+1 : end; }
+            bool AtEnd() const { return p == end; }
+            char Get() { return *p++; }
+            char Peek() const { return *p; }
+            const char* Position() const { return p; }
+
+            bool ReadWord(const char* w)
+            {
+                SkipBlank();
+                const std::size_t n = std::strlen(w);
+                if(std::size_t(end-p) < n || std::memcmp(p, w, n) != 0) return false;
+                p += n;
+                return p == end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n';
+            }
+
+            // numbers that do not fit into T are not read, OutOfRange() tells them apart from malformed ones
+            template<typename T>
+                typename std::enable_if<std::is_integral<T>::value, bool>::type Read(T& x)
+                {
+                    SkipBlank();
+                    bool negative = false;
+                    if(p < end && (*p == '-' || *p == '+')) { negative = *p == '-'; ++p; }
+                    const char* first = p;
+                    unsigned long long v = 0;
+                    unsigned d;
+                    bool overflow = false;
+                    while(p < end && (d = unsigned(*p - '0')) < 10) {
+                        if(v > (std::numeric_limits<unsigned long long>::max() - d)/10) overflow = true;
+                        v = 10*v + d;
+                        ++p;
+                    }
+                    if(p == first) return false;
+                    const unsigned long long max = static_cast<unsigned long long>(std::numeric_limits<T>::max());
+                    const unsigned long long max_negative = std::is_signed<T>::value ? max + 1 : 0;
+                    if(overflow || v > (negative ? max_negative : max)) { outOfRange = true; return false; }
+                    x = negative ? T(0 - v) : T(v);
+                    return true;
+                }
+
+            template<typename T>
+                typename std::enable_if<std::is_floating_point<T>::value, bool>::type Read(T& x)
+                {
+                    SkipBlank();
+                    // strtod needs a terminated string, the token is copied
+                    char token[128];
+                    std::size_t n = 0;
+                    for(; p+n < end && n < sizeof(token)-1; ++n) {
+                        const char c = p[n];
+                        if(!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) break;
+                        token[n] = c;
+                    }
+                    token[n] = 0;
+                    if(n == 0) return false;
+                    char* token_end;
+                    const T v = StrTo(token, &token_end, T());
+                    if(token_end != token + n) return false;
+                    if(std::isinf(v)) { outOfRange = true; return false; }
+                    p += n;
+                    x = v;
+                    return true;
+                }
+
+            bool OutOfRange() const { return outOfRange; }
+
+        private:
+            static float StrTo(const char* s, char** e, float) { return std::strtof(s, e); }
+            static double StrTo(const char* s, char** e, double) { return std::strtod(s, e); }
+            static long double StrTo(const char* s, char** e, long double) { return std::strtold(s, e); }
+
+            const char* p;
+            const char* end;
+            bool outOfRange = false;
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    // Snapshot file format, version 2. All integers are stored in native byte order, every section is padded to 8 bytes.
+    //   header
+    //   mcf_cost                                  1 x CostType
+    //   excess, potential                         no_nodes x FlowType, no_nodes x CostType
+    //   head, sister                              2*no_edges x uint64_t (node resp. arc index)
+    //   residual capacity, cost, capacity         2*no_edges x FlowType, CostType, FlowType
+    //   edge arc                                  no_edges x uint64_t (arc of each edge, see edge_arc())
+    // Version 1 files lack the edge arc section, their edges are at arcs 2*e.
+    /////////////////////////////////////////////////////////////////////////
+
+    struct SnapshotHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint32_t flow_size, flow_kind;
+        std::uint32_t cost_size, cost_kind;
+        std::uint64_t no_nodes, no_edges, no_edges_max;
+
+        static constexpr std::uint32_t current_version = 2;
+        static constexpr std::uint32_t native_byte_order = 0x01020304;
+        static const char* Magic() { return "MCF-SSP"; }
+        template<typename T> static std::uint32_t Kind() { return std::is_floating_point<T>::value ? 2 : (std::is_signed<T>::value ? 1 : 0); }
+        static std::size_t Padded(const std::size_t bytes) { return (bytes + 7) & ~std::size_t(7); }
+    };
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType>
+        void SSP<FlowType, CostType, PriorityQueue, IndexType>::save_snapshot(const std::string& filename) const
+        {
+            std::ofstream out(filename, std::ios::binary);
+            if(!out.is_open()) { throw std::runtime_error("could not open file " + filename); }
+
+            SnapshotHeader h;
+            std::memset(&h, 0, sizeof(h));
+            std::memcpy(h.magic, SnapshotHeader::Magic(), sizeof(h.magic));
+            h.version = SnapshotHeader::current_version;
+            h.byte_order = SnapshotHeader::native_byte_order;
+            h.flow_size = sizeof(FlowType);
+            h.flow_kind = SnapshotHeader::Kind<FlowType>();
+            h.cost_size = sizeof(CostType);
+            h.cost_kind = SnapshotHeader::Kind<CostType>();
+            h.no_nodes = nodeNum;
+            h.no_edges = edgeNum;
+            h.no_edges_max = edgeNumMax;
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+            std::vector<char> section;
+            auto write = [&](const std::size_t n, auto get) {
+                typedef decltype(get(0)) T;
+                section.assign(SnapshotHeader::Padded(n*sizeof(T)), 0);
+                for(std::size_t k=0; k<n; ++k) {
+                    const T x = get(k);
+                    std::memcpy(section.data() + k*sizeof(T), &x, sizeof(T));
+                }
+                out.write(section.data(), section.size());
+            };
+            write(1, [this](std::size_t) { return mcf_cost; });
+            write(nodeNum, [this](std::size_t i) { return nodes[i].excess; });
+            write(nodeNum, [this](std::size_t i) { return nodes[i].pi; });
+            write(2*edgeNum, [this](std::size_t e) { return std::uint64_t(arcs[e].head); });
+            write(2*edgeNum, [this](std::size_t e) { return std::uint64_t(arcs[e].sister); });
+            write(2*edgeNum, [this](std::size_t e) { return arcs[e].r_cap; });
+            write(2*edgeNum, [this](std::size_t e) { return arcs[e].cost; });
+            write(2*edgeNum, [this](std::size_t e) { return capacity[e]; });
+            write(edgeNum, [this](std::size_t e) { return std::uint64_t(edge_arc(e)); });
+            if(!out) { throw std::runtime_error("could not write snapshot to " + filename); }
+        }
+
+    template <typename FlowType, typename CostType, template<typename,typename> class PriorityQueue, typename IndexType>
+        void SSP<FlowType, CostType, PriorityQueue, IndexType>::load_snapshot(const std::string& filename)
+        {
+            const MappedFile file(filename);
+            auto error = [&filename](const std::string& msg) { return std::runtime_error("in snapshot " + filename + ": " + msg); };
+
+            SnapshotHeader h;
+            if(std::size_t(file.end() - file.begin()) < sizeof(h)) { throw error("file too short"); }
+            std::memcpy(&h, file.begin(), sizeof(h));
+            if(std::memcmp(h.magic, SnapshotHeader::Magic(), sizeof(h.magic)) != 0) { throw error("not a snapshot file"); }
+            if(h.version < 1 || h.version > SnapshotHeader::current_version) { throw error("unsupported version " + std::to_string(h.version)); }
+            if(h.byte_order != SnapshotHeader::native_byte_order) { throw error("written on a machine with different byte order"); }
+            if(h.flow_size != sizeof(FlowType) || h.flow_kind != SnapshotHeader::Kind<FlowType>() ||
+                    h.cost_size != sizeof(CostType) || h.cost_kind != SnapshotHeader::Kind<CostType>()) {
+                throw error("flow or cost type does not match");
+            }
+            if(h.no_edges > h.no_edges_max) { throw error("inconsistent number of edges"); }
+
+            const std::size_t n = h.no_nodes;
+            const std::size_t m = h.no_edges;
+            const std::size_t expected_size = sizeof(h) + SnapshotHeader::Padded(sizeof(CostType)) +
+                SnapshotHeader::Padded(n*sizeof(FlowType)) + SnapshotHeader::Padded(n*sizeof(CostType)) +
+                2*SnapshotHeader::Padded(2*m*sizeof(std::uint64_t)) +
+                2*SnapshotHeader::Padded(2*m*sizeof(FlowType)) + SnapshotHeader::Padded(2*m*sizeof(CostType)) +
+                (h.version >= 2 ? SnapshotHeader::Padded(m*sizeof(std::uint64_t)) : 0);
+            if(std::size_t(file.end() - file.begin()) != expected_size) { throw error("unexpected file size"); }
+
+            const char* p = file.begin() + sizeof(h);
+            auto section = [&p](const std::size_t n, auto* type) {
+                typedef typename std::remove_pointer<decltype(type)>::type T;
+                const char* begin = p;
+                p += SnapshotHeader::Padded(n*sizeof(T));
+                return [begin](const std::size_t k) { T x; std::memcpy(&x, begin + k*sizeof(T), sizeof(T)); return x; };
+            };
+            const auto cost_section = section(1, (CostType*)nullptr);
+            const auto excess_section = section(n, (FlowType*)nullptr);
+            const auto pi_section = section(n, (CostType*)nullptr);
+            const auto head_section = section(2*m, (std::uint64_t*)nullptr);
+            const auto sister_section = section(2*m, (std::uint64_t*)nullptr);
+            const auto r_cap_section = section(2*m, (FlowType*)nullptr);
+            const auto arc_cost_section = section(2*m, (CostType*)nullptr);
+            const auto capacity_section = section(2*m, (FlowType*)nullptr);
+            const auto edge_arc_section = section(h.version >= 2 ? m : 0, (std::uint64_t*)nullptr);
+
+            SSP s(n, h.no_edges_max);
+            s.edgeNum = m;
+            s.mcf_cost = cost_section(0);
+            for(NodeId i=0; i<n; ++i) {
+                s.nodes[i].excess = excess_section(i);
+                s.nodes[i].pi = pi_section(i);
+            }
+            // indices are stored as 64 bit values independently of IndexType
+            for(EdgeId e=0; e<2*m; ++e) {
+                const std::uint64_t head = head_section(e);
+                const std::uint64_t sister = sister_section(e);
+                if(head >= n || sister >= 2*m || sister == e || sister_section(sister) != e) { throw error("corrupt arc " + std::to_string(e)); }
+                s.arcs[e].head = head;
+                s.arcs[e].sister = sister;
+                s.arcs[e].r_cap = r_cap_section(e);
+                s.arcs[e].cost = arc_cost_section(e);
+                s.capacity[e] = capacity_section(e);
+            }
+            if(h.version >= 2) {
+                s.edgeArc.resize(m);
+                for(EdgeId e=0; e<m; ++e) {
+                    const std::uint64_t a = edge_arc_section(e);
+                    if(a >= 2*m) { throw error("corrupt arc of edge " + std::to_string(e)); }
+                    s.edgeArc[e] = a;
+                }
+            }
+            s.LinkArcs();
+            for(NodeId i=0; i<n; ++i) {
+                if(s.nodes[i].excess > 0) {
+                    s.nodes[i].next = s.firstActive;
+                    s.firstActive = i;
+                }
+            }
+
+            swap(*this, s);
+        }
+
+    // read file in DIMACS format. Large files are parsed by no_threads threads in parallel (0: choose automatically),
+    // each of which first counts and then fills its share of the arc arrays.
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE = BinaryHeap, typename INDEX_TYPE = std::uint32_t>
+        SSP<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE> load_dimacs_file(const std::string& filename, std::size_t no_threads = 0)
+        {
+            typedef SSP<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE> SSP_TYPE;
+            typedef typename SSP_TYPE::NodeId NodeId;
+
+            const MappedFile file(filename);
+            auto error = [&filename](const std::size_t line, const std::string& msg) {
+                return std::runtime_error("in file " + filename + ", line " + std::to_string(line) + ": " + msg);
+            };
+            auto read_error = [&error](const DimacsScanner& s, const std::size_t line, const std::string& msg) {
+                return error(line, s.OutOfRange() ? "number out of range" : msg);
+            };
+
+            // the problem line must precede all node and arc lines
+            DimacsScanner header(file.begin(), file.end());
+            std::size_t line_no = 1;
+            std::size_t n = 0; // number of nodes
+            std::size_t m = 0; // number of arcs
+            for(;; ++line_no) {
+                if(header.AtEnd()) { throw std::runtime_error("in file " + filename + ": no line beginning with 'p' found"); }
+                if(header.AtLineEnd()) { header.SkipLine(); continue; }
+                const char id = header.Get();
+                if(id == 'c') { header.SkipLine(); continue; }
+                if(id != 'p') { throw error(line_no, std::string("expected line beginning with 'p' before line beginning with '") + id + "'"); }
+                if(!header.ReadWord("min")) { throw error(line_no, "min must come after 'p'"); }
+                if(!header.Read(n) || !header.Read(m) || !header.AtLineEnd()) { throw read_error(header, line_no, "cannot read number of nodes and arcs"); }
+                header.SkipLine();
+                ++line_no;
+                break;
+            }
+
+            // split remaining lines into chunks
+            const char* body = header.Position();
+            const std::size_t body_size = file.end() - body;
+            if(no_threads == 0) {
+                no_threads = std::max(std::size_t(1), std::min(std::size_t(std::thread::hardware_concurrency()), body_size/(std::size_t(1) << 22)));
+            }
+            std::vector<const char*> chunk(no_threads+1, file.end());
+            chunk[0] = body;
+            for(std::size_t t=1; t<no_threads; ++t) {
+                const char* p = std::max(chunk[t-1], body + t*(body_size/no_threads));
+                if(p > body && p < file.end() && p[-1] != '\n') {
+                    p = static_cast<const char*>(std::memchr(p, '\n', file.end()-p));
+                    p = p ? p+1 : file.end();
+                }
+                chunk[t] = p;
+            }
+
+            // first pass: count lines and arcs per chunk
+            std::vector<std::size_t> first_line(no_threads+1, 0);
+            std::vector<std::size_t> first_arc(no_threads+1, 0);
+            run_parallel(no_threads, [&](const std::size_t t) {
+                std::size_t lines = 0, arcs = 0;
+                for(const char* p = chunk[t]; p < chunk[t+1]; ) {
+                    DimacsScanner s(p, chunk[t+1]);
+                    s.SkipBlank();
+                    if(!s.AtEnd() && s.Peek() == 'a') ++arcs;
+                    s.SkipLine();
+                    p = s.Position();
+                    ++lines;
+                }
+                first_line[t+1] = lines;
+                first_arc[t+1] = arcs;
+            });
+            first_line[0] = line_no;
+            std::partial_sum(first_line.begin(), first_line.end(), first_line.begin());
+            std::partial_sum(first_arc.begin(), first_arc.end(), first_arc.begin());
+            const std::size_t no_arcs = first_arc[no_threads];
+
+            // second pass: parse chunks into their part of the arc arrays
+            std::vector<NodeId> tails(no_arcs), heads(no_arcs);
+            std::vector<FLOW_TYPE> lower(no_arcs), upper(no_arcs);
+            std::vector<COST_TYPE> cost(no_arcs);
+            std::vector<std::vector<std::pair<NodeId,FLOW_TYPE>>> excess(no_threads);
+            // an error in several chunks is reported for the smallest line number
+            run_parallel(no_threads, [&](const std::size_t t) {
+                std::size_t line = first_line[t];
+                std::size_t e = first_arc[t];
+                DimacsScanner s(chunk[t], chunk[t+1]);
+                for(; !s.AtEnd(); s.SkipLine(), ++line) {
+                    if(s.AtLineEnd()) continue;
+                    const char id = s.Get();
+                    switch(id) {
+                        case 'c':
+                            break;
+                        case 'p':
+                            throw error(line, "not more than one line beginning with 'p' allowed");
+                        case 'n':
+                            {
+                                std::size_t i;
+                                FLOW_TYPE flow;
+                                if(!s.Read(i) || !s.Read(flow) || !s.AtLineEnd()) { throw read_error(s, line, "cannot read node id and external flow"); }
+                                if(i < 1 || i > n) { throw error(line, "node id " + std::to_string(i) + " out of range"); }
+                                excess[t].push_back({i-1, flow});
+                                break;
+                            }
+                        case 'a':
+                            {
+                                std::size_t i, j;
+                                if(!s.Read(i) || !s.Read(j) || !s.Read(lower[e]) || !s.Read(upper[e]) || !s.Read(cost[e]) || !s.AtLineEnd()) {
+                                    throw read_error(s, line, "cannot read arc information");
+                                }
+                                if(i < 1 || i > n || j < 1 || j > n) { throw error(line, "arc endpoint out of range"); }
+                                if(i == j) { throw error(line, "loops are not supported"); }
+                                if(lower[e] > 0 || upper[e] < 0 || lower[e] >= upper[e]) { throw error(line, "arc bounds must satisfy lower <= 0 <= upper and lower < upper"); }
+                                if(e >= m) { throw error(line, "more arcs than announced in line beginning with 'p'"); }
+                                tails[e] = i-1;
+                                heads[e] = j-1;
+                                ++e;
+                                break;
+                            }
+                        default:
+                            throw error(line, std::string("unknown line identifier '") + id + "'");
+                    }
+                }
+            });
+
+            SSP_TYPE f(n, m);
+            f.add_edges(tails, heads, lower, upper, cost);
+            for(const auto& x : excess) {
+                for(const auto& i : x) { f.add_node_excess(i.first, i.second); }
+            }
+            return f;
+        }
+
+    // read file in DIMACS format
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE = BinaryHeap, typename INDEX_TYPE = std::uint32_t>
+        SSP<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>* read_dimacs_file(const std::string& filename)
+        {
+            return new SSP<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>(load_dimacs_file<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>(filename));
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    // Solving many independent problems
+
+    // problem in the format of SSP::add_edges. excess is either empty or has one entry per node
+    template<typename FLOW_TYPE, typename COST_TYPE> struct BatchProblem
+    {
+        std::size_t no_nodes = 0;
+        std::vector<std::size_t> tails, heads;
+        std::vector<FLOW_TYPE> lower, upper;
+        std::vector<COST_TYPE> cost;
+        std::vector<FLOW_TYPE> excess;
+    };
+
+    template<typename FLOW_TYPE, typename COST_TYPE> struct BatchSolution
+    {
+        COST_TYPE objective = 0;
+        std::vector<FLOW_TYPE> flow; // flow of every edge in the order of BatchProblem::tails
+        std::vector<COST_TYPE> potential; // potential of every node, see SSP::potential
+    };
+
+    // pool of no_threads workers (0: choose automatically) for solving many batches of problems. The threads and the SSP
+    // of every worker are kept alive between calls of solve(), so small batches do not pay for thread creation and
+    // allocation again. The calling thread works as one of the workers, so no_threads-1 threads are started.
+    // Problems are split into contiguous ranges, one per worker. A worker that has finished its range steals half
+    // of the remaining problems of another worker. solve() must not be called concurrently on the same pool.
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE = BinaryHeap, typename INDEX_TYPE = std::uint32_t>
+    class BatchSolver
+    {
+        public:
+            explicit BatchSolver(std::size_t no_threads = 0);
+            ~BatchSolver();
+            BatchSolver(const BatchSolver&) = delete;
+            BatchSolver& operator=(const BatchSolver&) = delete;
+
+            // if problems_per_second is given, the throughput is stored there. The first exception thrown by a worker
+            // is rethrown after all workers have finished the batch, the pool stays usable.
+            std::vector<BatchSolution<FLOW_TYPE,COST_TYPE>> solve(const std::vector<BatchProblem<FLOW_TYPE,COST_TYPE>>& problems,
+                    double* problems_per_second = nullptr);
+
+            std::size_t no_threads() const { return work.size(); }
+
+        private:
+            struct WorkRange
+            {
+                std::mutex m;
+                std::size_t begin = 0, end = 0;
+            };
+
+            std::vector<WorkRange> work;
+            std::vector<SSP<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>> solvers;
+            std::vector<std::exception_ptr> errors;
+            std::vector<std::thread> threads;
+
+            // current batch, valid while the workers are busy
+            const std::vector<BatchProblem<FLOW_TYPE,COST_TYPE>>* problems = nullptr;
+            std::vector<BatchSolution<FLOW_TYPE,COST_TYPE>>* solutions = nullptr;
+
+            std::mutex m;
+            std::condition_variable batchStarted, batchFinished;
+            std::size_t batch = 0; // number of started batches
+            std::size_t busy = 0; // started threads that have not finished the current batch
+            bool stop = false;
+
+            void Run(const std::size_t t); // loop of the started thread t
+            void Work(const std::size_t t); // solve problems of the current batch until none is left
+            bool NextProblem(const std::size_t t, std::size_t& p);
+            void Stop();
+    };
+
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE, typename INDEX_TYPE>
+        BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>::BatchSolver(std::size_t no_threads)
+        : work(no_threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : no_threads),
+        solvers(work.size()),
+        errors(work.size())
+        {
+            try {
+                for(std::size_t t=1; t<work.size(); ++t) { threads.emplace_back(&BatchSolver::Run, this, t); }
+            } catch(...) {
+                Stop();
+                throw;
+            }
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE, typename INDEX_TYPE>
+        BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>::~BatchSolver()
+        {
+            Stop();
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE, typename INDEX_TYPE>
+        void BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>::Stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                stop = true;
+            }
+            batchStarted.notify_all();
+            for(auto& th : threads) { th.join(); }
+            threads.clear();
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE, typename INDEX_TYPE>
+        void BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>::Run(const std::size_t t)
+        {
+            std::size_t done = 0; // batches this thread has worked on
+            while(true) {
+                {
+                    std::unique_lock<std::mutex> lock(m);
+                    batchStarted.wait(lock, [&]() { return stop || batch != done; });
+                    if(stop) return;
+                    done = batch;
+                }
+                Work(t);
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    --busy;
+                }
+                batchFinished.notify_one();
+            }
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE, typename INDEX_TYPE>
+        std::vector<BatchSolution<FLOW_TYPE,COST_TYPE>> BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>::solve(
+                const std::vector<BatchProblem<FLOW_TYPE,COST_TYPE>>& batch_problems, double* problems_per_second)
+        {
+            const auto begin_time = std::chrono::steady_clock::now();
+            std::vector<BatchSolution<FLOW_TYPE,COST_TYPE>> batch_solutions(batch_problems.size());
+            problems = &batch_problems;
+            solutions = &batch_solutions;
+            for(std::size_t t=0; t<work.size(); ++t) {
+                work[t].begin = t*batch_problems.size()/work.size();
+                work[t].end = (t+1)*batch_problems.size()/work.size();
+                errors[t] = nullptr;
+            }
+
+            if(!batch_problems.empty()) {
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    ++batch;
+                    busy = threads.size();
+                }
+                batchStarted.notify_all();
+                Work(0);
+                std::unique_lock<std::mutex> lock(m);
+                batchFinished.wait(lock, [&]() { return busy == 0; });
+            }
+            problems = nullptr;
+            solutions = nullptr;
+            for(auto& e : errors) {
+                if(e) { std::rethrow_exception(e); }
+            }
+
+            if(problems_per_second != nullptr) {
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_time).count();
+                *problems_per_second = seconds > 0.0 ? batch_problems.size()/seconds : 0.0;
+            }
+            return batch_solutions;
+        }
+
+    // take the next problem from the own range, otherwise steal from the back of another one
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE, typename INDEX_TYPE>
+        bool BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>::NextProblem(const std::size_t t, std::size_t& p)
+        {
+            {
+                std::lock_guard<std::mutex> lock(work[t].m);
+                if(work[t].begin < work[t].end) { p = work[t].begin++; return true; }
+            }
+            for(std::size_t k=1; k<work.size(); ++k) {
+                WorkRange& victim = work[(t+k)%work.size()];
+                std::size_t begin, end;
+                {
+                    std::lock_guard<std::mutex> lock(victim.m);
+                    if(victim.begin >= victim.end) continue;
+                    begin = victim.begin + (victim.end - victim.begin)/2;
+                    end = victim.end;
+                    victim.end = begin;
+                }
+                std::lock_guard<std::mutex> lock(work[t].m);
+                p = begin;
+                work[t].begin = begin+1;
+                work[t].end = end;
+                return true;
+            }
+            return false;
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE, typename INDEX_TYPE>
+        void BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>::Work(const std::size_t t)
+        {
+            try {
+                auto& mcf = solvers[t];
+                std::size_t p;
+                while(NextProblem(t, p)) {
+                    const auto& problem = (*problems)[p];
+                    assert(problem.excess.empty() || problem.excess.size() == problem.no_nodes);
+                    mcf.reset(problem.no_nodes, problem.tails.size());
+                    mcf.add_edges(problem.tails, problem.heads, problem.lower, problem.upper, problem.cost);
+                    for(std::size_t i=0; i<problem.excess.size(); ++i) {
+                        if(problem.excess[i] != 0) { mcf.add_node_excess(i, problem.excess[i]); }
+                    }
+                    auto& solution = (*solutions)[p];
+                    solution.objective = mcf.solve();
+                    solution.flow.resize(problem.tails.size());
+                    for(std::size_t e=0; e<problem.tails.size(); ++e) {
+                        solution.flow[e] = mcf.flow(2*e);
+                    }
+                    solution.potential.resize(problem.no_nodes);
+                    for(std::size_t i=0; i<problem.no_nodes; ++i) {
+                        solution.potential[i] = mcf.potential(i);
+                    }
+                }
+            } catch(...) {
+                errors[t] = std::current_exception();
+            }
+        }
+
+    // solve a single batch on no_threads threads (0: choose automatically, never more than there are problems).
+    // The threads are created and joined within this call. When solving many batches, keep a BatchSolver instead.
+    // If problems_per_second is given, the throughput including thread creation is stored there.
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE = BinaryHeap, typename INDEX_TYPE = std::uint32_t>
+        std::vector<BatchSolution<FLOW_TYPE,COST_TYPE>> solve_batch(const std::vector<BatchProblem<FLOW_TYPE,COST_TYPE>>& problems,
+                std::size_t no_threads = 0, double* problems_per_second = nullptr)
+        {
+            const auto begin_time = std::chrono::steady_clock::now();
+            if(no_threads == 0) {
+                no_threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            no_threads = std::max(std::size_t(1), std::min(no_threads, problems.size()));
+
+            BatchSolver<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE> pool(no_threads);
+            auto solutions = pool.solve(problems);
+
+            if(problems_per_second != nullptr) {
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_time).count();
+                *problems_per_second = seconds > 0.0 ? problems.size()/seconds : 0.0;
+            }
+            return solutions;
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    // Presolve
+
+    // reduces a problem before solving and maps solutions of the reduced problem back. Reductions are applied until none is left:
+    //   - arcs with equal bounds carry fixed flow, self loops take the bound their cost prefers
+    //   - parallel and antiparallel arcs of equal cost (after orienting them the same way) are merged into one arc.
+    //     Parallel arcs of different cost are kept, together they already form a piecewise linear cost bundle
+    //   - nodes with a single arc pass their whole excess over it (forced flow)
+    //   - nodes without excess and with two arcs are contracted, the two arcs become one with summed cost
+    // Remaining arcs are split into weakly connected components, which are independent problems. Merged and contracted arcs
+    // may have lower < 0, their lower bound is moved into the excesses of the endpoints, so every component arc has bounds [0, upper-lower].
+    // Infeasibility detected on the way (forced flow out of bounds, components with nonzero total excess) throws std::runtime_error.
+    template<typename FLOW_TYPE, typename COST_TYPE> class Presolve
+    {
+        public:
+            explicit Presolve(const BatchProblem<FLOW_TYPE,COST_TYPE>& problem);
+
+            // reduced problems, one per weakly connected component that still has arcs
+            const std::vector<BatchProblem<FLOW_TYPE,COST_TYPE>>& components() const { return componentProblems; }
+            // flow of every original edge, potential of every original node and objective from solutions of components().
+            // If the solutions are optimal, so is the result.
+            BatchSolution<FLOW_TYPE,COST_TYPE> postsolve(const std::vector<BatchSolution<FLOW_TYPE,COST_TYPE>>& solutions) const;
+
+            std::size_t no_nodes() const { return nodeNum; }
+            std::size_t no_edges() const { return edgeNum; }
+            // summed over all components
+            std::size_t no_reduced_nodes() const;
+            std::size_t no_reduced_edges() const;
+
+        private:
+            struct Arc
+            {
+                std::size_t tail, head;
+                FLOW_TYPE lower, upper;
+                COST_TYPE cost;
+                bool alive;
+            };
+            // arc replaced by another one, whose flow times sign is the flow of arc
+            struct Member
+            {
+                std::size_t arc;
+                int sign;
+            };
+            // reductions are undone in reverse order by postsolve
+            struct Reduction
+            {
+                enum Kind { fixed, leaf, merge, series } kind;
+                std::size_t arc; // fixed, leaf: removed arc. merge, series: arc replacing the members
+                std::size_t node; // leaf, series: removed node
+                FLOW_TYPE flow; // fixed, leaf
+                std::size_t first; // merge, series: members[first,...,last), for series the first is adjacent to the tail of arc
+                std::size_t last;
+            };
+
+            std::size_t nodeNum, edgeNum;
+            std::vector<Arc> arcs; // original edges first, then arcs added by reductions
+            std::vector<FLOW_TYPE> excess;
+            std::vector<std::vector<std::size_t>> incident; // arcs at each node, dead ones are removed lazily
+            std::vector<bool> removed;
+            std::vector<Member> members;
+            std::vector<Reduction> reductions;
+
+            std::vector<BatchProblem<FLOW_TYPE,COST_TYPE>> componentProblems;
+            std::vector<std::vector<std::size_t>> componentArcs, componentNodes; // original id of every arc and node of a component
+
+            std::size_t Other(const std::size_t a, const std::size_t i) const { return arcs[a].tail == i ? arcs[a].head : arcs[a].tail; }
+            // bounds and cost of arc a when its flow is multiplied by sign
+            FLOW_TYPE Lower(const std::size_t a, const int sign) const { return sign > 0 ? arcs[a].lower : -arcs[a].upper; }
+            FLOW_TYPE Upper(const std::size_t a, const int sign) const { return sign > 0 ? arcs[a].upper : -arcs[a].lower; }
+            COST_TYPE Cost(const std::size_t a, const int sign) const { return sign > 0 ? arcs[a].cost : -arcs[a].cost; }
+
+            std::size_t AddArc(std::size_t tail, std::size_t head, FLOW_TYPE lower, FLOW_TYPE upper, COST_TYPE cost);
+            void Fix(std::size_t a, FLOW_TYPE flow);
+            // remove arcs with equal bounds and self loops. Returns whether arcs were removed
+            bool FixArc(std::size_t a);
+            bool MergeParallel();
+            bool EliminateNodes();
+            void Split();
+            static std::runtime_error Infeasible(const std::string& msg) { return std::runtime_error("MCF::Presolve: problem infeasible, " + msg); }
+    };
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        Presolve<FLOW_TYPE,COST_TYPE>::Presolve(const BatchProblem<FLOW_TYPE,COST_TYPE>& problem)
+        : nodeNum(problem.no_nodes),
+        edgeNum(problem.tails.size()),
+        excess(problem.excess),
+        incident(problem.no_nodes),
+        removed(problem.no_nodes, false)
+        {
+            assert(problem.heads.size() == edgeNum && problem.lower.size() == edgeNum && problem.upper.size() == edgeNum && problem.cost.size() == edgeNum);
+            excess.resize(nodeNum, 0);
+            for(std::size_t e=0; e<edgeNum; ++e) {
+                assert(problem.tails[e] < nodeNum && problem.heads[e] < nodeNum);
+                assert(problem.lower[e] <= 0 && problem.upper[e] >= 0);
+                AddArc(problem.tails[e], problem.heads[e], problem.lower[e], problem.upper[e], problem.cost[e]);
+            }
+            for(std::size_t a=0; a<edgeNum; ++a) { FixArc(a); }
+
+            EliminateNodes();
+            while(MergeParallel() && EliminateNodes()) {}
+            Split();
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        std::size_t Presolve<FLOW_TYPE,COST_TYPE>::AddArc(std::size_t tail, std::size_t head, FLOW_TYPE lower, FLOW_TYPE upper, COST_TYPE cost)
+        {
+            arcs.push_back({tail, head, lower, upper, cost, true});
+            incident[tail].push_back(arcs.size()-1);
+            if(head != tail) { incident[head].push_back(arcs.size()-1); }
+            return arcs.size()-1;
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        void Presolve<FLOW_TYPE,COST_TYPE>::Fix(const std::size_t a, const FLOW_TYPE flow)
+        {
+            assert(arcs[a].alive && arcs[a].lower <= flow && flow <= arcs[a].upper);
+            arcs[a].alive = false;
+            excess[arcs[a].tail] -= flow;
+            excess[arcs[a].head] += flow;
+            reductions.push_back({Reduction::fixed, a, 0, flow, 0, 0});
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        bool Presolve<FLOW_TYPE,COST_TYPE>::FixArc(const std::size_t a)
+        {
+            const Arc& arc = arcs[a];
+            if(arc.tail == arc.head) {
+                Fix(a, arc.cost < 0 ? arc.upper : (arc.cost > 0 ? arc.lower : 0));
+                return true;
+            }
+            if(arc.lower == arc.upper) {
+                Fix(a, arc.lower);
+                return true;
+            }
+            return false;
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        bool Presolve<FLOW_TYPE,COST_TYPE>::MergeParallel()
+        {
+            // orient every arc from its smaller to its larger endpoint, then equal (tail, head, cost) are adjacent
+            struct Key
+            {
+                std::size_t tail, head;
+                COST_TYPE cost;
+                std::size_t arc;
+                int sign;
+                bool operator<(const Key& o) const { return std::tie(tail, head, cost, arc) < std::tie(o.tail, o.head, o.cost, o.arc); }
+                bool operator==(const Key& o) const { return tail == o.tail && head == o.head && cost == o.cost; }
+            };
+            std::vector<Key> keys;
+            for(std::size_t a=0; a<arcs.size(); ++a) {
+                if(!arcs[a].alive) { continue; }
+                const int sign = arcs[a].tail < arcs[a].head ? 1 : -1;
+                keys.push_back({std::min(arcs[a].tail, arcs[a].head), std::max(arcs[a].tail, arcs[a].head), Cost(a, sign), a, sign});
+            }
+            std::sort(keys.begin(), keys.end());
+
+            bool merged = false;
+            for(std::size_t k=0; k<keys.size(); ) {
+                std::size_t l = k+1;
+                while(l < keys.size() && keys[l] == keys[k]) { ++l; }
+                if(l == k+1) { k = l; continue; }
+
+                const std::size_t first = members.size();
+                FLOW_TYPE lower = 0, upper = 0;
+                for(std::size_t j=k; j<l; ++j) {
+                    arcs[keys[j].arc].alive = false;
+                    lower += Lower(keys[j].arc, keys[j].sign);
+                    upper += Upper(keys[j].arc, keys[j].sign);
+                    members.push_back({keys[j].arc, keys[j].sign});
+                }
+                const std::size_t a = AddArc(keys[k].tail, keys[k].head, lower, upper, keys[k].cost);
+                reductions.push_back({Reduction::merge, a, 0, 0, first, members.size()});
+                FixArc(a);
+                merged = true;
+                k = l;
+            }
+            return merged;
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        bool Presolve<FLOW_TYPE,COST_TYPE>::EliminateNodes()
+        {
+            bool eliminated = false;
+            std::vector<std::size_t> queue(nodeNum);
+            std::iota(queue.begin(), queue.end(), 0);
+            while(!queue.empty()) {
+                const std::size_t v = queue.back();
+                queue.pop_back();
+                if(removed[v]) { continue; }
+                auto& inc = incident[v];
+                inc.erase(std::remove_if(inc.begin(), inc.end(), [this](const std::size_t a) { return !arcs[a].alive; }), inc.end());
+
+                if(inc.empty()) {
+                    if(excess[v] != 0) { throw Infeasible("isolated node " + std::to_string(v) + " has excess"); }
+                    removed[v] = true;
+                } else if(inc.size() == 1) {
+                    // the whole excess leaves over the only arc
+                    const std::size_t a = inc[0];
+                    const std::size_t u = Other(a, v);
+                    const FLOW_TYPE flow = arcs[a].tail == v ? excess[v] : -excess[v];
+                    if(flow < arcs[a].lower || flow > arcs[a].upper) { throw Infeasible("forced flow on edge out of bounds"); }
+                    arcs[a].alive = false;
+                    excess[u] += excess[v];
+                    excess[v] = 0;
+                    removed[v] = true;
+                    reductions.push_back({Reduction::leaf, a, v, flow, 0, 0});
+                    queue.push_back(u);
+                } else if(inc.size() == 2 && excess[v] == 0) {
+                    // path u -a-> v -b-> w with both arcs oriented along it, both carry the same flow
+                    std::size_t a = inc[0], b = inc[1];
+                    int sa = arcs[a].head == v ? 1 : -1;
+                    int sb = arcs[b].tail == v ? 1 : -1;
+                    std::size_t u = Other(a, v), w = Other(b, v);
+                    FLOW_TYPE lower = std::max(Lower(a, sa), Lower(b, sb));
+                    FLOW_TYPE upper = std::min(Upper(a, sa), Upper(b, sb));
+                    COST_TYPE cost = Cost(a, sa) + Cost(b, sb);
+                    if(lower > upper) { throw Infeasible("bounds of a path do not overlap"); }
+                    // keep lower < 0 only together with upper > 0 by reversing the path
+                    if(upper == 0 && lower < 0) {
+                        std::swap(a, b);
+                        std::swap(u, w);
+                        std::swap(sa, sb);
+                        sa = -sa;
+                        sb = -sb;
+                        std::swap(lower, upper);
+                        lower = -lower;
+                        upper = -upper;
+                        cost = -cost;
+                    }
+                    arcs[a].alive = false;
+                    arcs[b].alive = false;
+                    removed[v] = true;
+                    const std::size_t first = members.size();
+                    members.push_back({a, sa});
+                    members.push_back({b, sb});
+                    const std::size_t c = AddArc(u, w, lower, upper, cost);
+                    reductions.push_back({Reduction::series, c, v, 0, first, members.size()});
+                    if(FixArc(c)) {
+                        queue.push_back(u);
+                        queue.push_back(w);
+                    }
+                } else {
+                    continue;
+                }
+                eliminated = true;
+            }
+            return eliminated;
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        void Presolve<FLOW_TYPE,COST_TYPE>::Split()
+        {
+            std::vector<std::size_t> root(nodeNum);
+            std::iota(root.begin(), root.end(), 0);
+            auto find = [&root](std::size_t i) {
+                while(root[i] != i) { i = root[i] = root[root[i]]; }
+                return i;
+            };
+            for(const Arc& a : arcs) {
+                if(a.alive) { root[find(a.tail)] = find(a.head); }
+            }
+
+            // components and local node ids are numbered in order of first appearance
+            const std::size_t none = std::numeric_limits<std::size_t>::max();
+            std::vector<std::size_t> component(nodeNum, none), local(nodeNum, none);
+            auto add_node = [&](const std::size_t i, const std::size_t c) {
+                if(local[i] == none) {
+                    local[i] = componentProblems[c].no_nodes++;
+                    componentProblems[c].excess.push_back(excess[i]);
+                    componentNodes[c].push_back(i);
+                }
+                return local[i];
+            };
+            for(std::size_t a=0; a<arcs.size(); ++a) {
+                if(!arcs[a].alive) { continue; }
+                const std::size_t r = find(arcs[a].tail);
+                if(component[r] == none) {
+                    component[r] = componentProblems.size();
+                    componentProblems.emplace_back();
+                    componentArcs.emplace_back();
+                    componentNodes.emplace_back();
+                }
+                const std::size_t c = component[r];
+                const std::size_t i = add_node(arcs[a].tail, c);
+                const std::size_t j = add_node(arcs[a].head, c);
+                auto& p = componentProblems[c];
+                p.tails.push_back(i);
+                p.heads.push_back(j);
+                p.lower.push_back(0);
+                p.upper.push_back(arcs[a].upper - arcs[a].lower);
+                p.excess[i] -= arcs[a].lower;
+                p.excess[j] += arcs[a].lower;
+                p.cost.push_back(arcs[a].cost);
+                componentArcs[c].push_back(a);
+            }
+            for(const auto& p : componentProblems) {
+                if(std::accumulate(p.excess.begin(), p.excess.end(), FLOW_TYPE(0)) != 0) { throw Infeasible("excess of a component does not sum to zero"); }
+            }
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        std::size_t Presolve<FLOW_TYPE,COST_TYPE>::no_reduced_nodes() const
+        {
+            std::size_t n = 0;
+            for(const auto& p : componentProblems) { n += p.no_nodes; }
+            return n;
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        std::size_t Presolve<FLOW_TYPE,COST_TYPE>::no_reduced_edges() const
+        {
+            std::size_t m = 0;
+            for(const auto& p : componentProblems) { m += p.tails.size(); }
+            return m;
+        }
+
+    template<typename FLOW_TYPE, typename COST_TYPE>
+        BatchSolution<FLOW_TYPE,COST_TYPE> Presolve<FLOW_TYPE,COST_TYPE>::postsolve(const std::vector<BatchSolution<FLOW_TYPE,COST_TYPE>>& solutions) const
+        {
+            if(solutions.size() != componentProblems.size()) { throw std::invalid_argument("MCF::Presolve: one solution per component expected"); }
+            std::vector<FLOW_TYPE> flow(arcs.size(), 0);
+            std::vector<COST_TYPE> pi(nodeNum, 0);
+            for(std::size_t c=0; c<solutions.size(); ++c) {
+                assert(solutions[c].flow.size() == componentArcs[c].size() && solutions[c].potential.size() == componentNodes[c].size());
+                for(std::size_t k=0; k<componentArcs[c].size(); ++k) {
+                    const std::size_t a = componentArcs[c][k];
+                    flow[a] = solutions[c].flow[k] + arcs[a].lower;
+                }
+                for(std::size_t k=0; k<componentNodes[c].size(); ++k) { pi[componentNodes[c][k]] = solutions[c].potential[k]; }
+            }
+
+            // the arc replacing others and the endpoints of removed nodes got their values from later reductions
+            for(auto r=reductions.rbegin(); r!=reductions.rend(); ++r) {
+                const Arc& arc = arcs[r->arc];
+                switch(r->kind) {
+                    case Reduction::fixed:
+                        flow[r->arc] = r->flow;
+                        break;
+                    case Reduction::leaf:
+                        // zero reduced cost on the leaf arc
+                        flow[r->arc] = r->flow;
+                        if(arc.tail == r->node) { pi[r->node] = arc.cost + pi[arc.head]; }
+                        else { pi[r->node] = pi[arc.tail] - arc.cost; }
+                        break;
+                    case Reduction::merge: {
+                        // fill members up to their upper bound one after another, all have the same reduced cost
+                        FLOW_TYPE left = flow[r->arc];
+                        for(std::size_t k=r->first; k<r->last; ++k) { left -= Lower(members[k].arc, members[k].sign); }
+                        for(std::size_t k=r->first; k<r->last; ++k) {
+                            const Member& m = members[k];
+                            const FLOW_TYPE lower = Lower(m.arc, m.sign);
+                            const FLOW_TYPE f = lower + std::min(left, Upper(m.arc, m.sign) - lower);
+                            left -= f - lower;
+                            flow[m.arc] = m.sign*f;
+                        }
+                        assert(left == 0);
+                        break;
+                    }
+                    case Reduction::series: {
+                        // the reduced cost of the path is put on the arc at its bound, the other one gets zero reduced cost
+                        const Member& a = members[r->first];
+                        const Member& b = members[r->first+1];
+                        const FLOW_TYPE f = flow[r->arc];
+                        flow[a.arc] = a.sign*f;
+                        flow[b.arc] = b.sign*f;
+                        const COST_TYPE reduced = arc.cost + pi[arc.head] - pi[arc.tail];
+                        const bool on_a = (reduced < 0 && f == Upper(a.arc, a.sign)) || (reduced > 0 && f == Lower(a.arc, a.sign));
+                        pi[r->node] = pi[arc.tail] - Cost(a.arc, a.sign) + (on_a ? reduced : 0);
+                        break;
+                    }
+                }
+            }
+
+            BatchSolution<FLOW_TYPE,COST_TYPE> solution;
+            solution.flow.assign(flow.begin(), flow.begin() + edgeNum);
+            solution.potential = pi;
+            for(std::size_t e=0; e<edgeNum; ++e) { solution.objective += arcs[e].cost*flow[e]; }
+            return solution;
+        }
+
+    // presolve the problem, solve its components in parallel with solve_batch and map the solution back
+    template<typename FLOW_TYPE, typename COST_TYPE, template<typename,typename> class PRIORITY_QUEUE = BinaryHeap, typename INDEX_TYPE = std::uint32_t>
+        BatchSolution<FLOW_TYPE,COST_TYPE> solve_presolved(const BatchProblem<FLOW_TYPE,COST_TYPE>& problem, std::size_t no_threads = 0)
+        {
+            const Presolve<FLOW_TYPE,COST_TYPE> presolve(problem);
+            return presolve.postsolve(solve_batch<FLOW_TYPE,COST_TYPE,PRIORITY_QUEUE,INDEX_TYPE>(presolve.components(), no_threads));
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    // Dense assignment problems
+
+    // min cost assignment of no_rows rows to distinct columns out of no_cols >= no_rows, with a dense row-major cost matrix.
+    // For integer costs, path lengths must stay below half the maximum of CostType.
+    // Solves the same problem as SSP on the bipartite graph with unit capacities, rows being nodes 0,...,no_rows-1 and
+    // columns nodes no_rows,...,no_rows+no_cols-1, but without arc records, lists and heap: every Dijkstra step scans one
+    // full cost row (Jonker-Volgenant shortest augmenting path). Row scans and the search for the next column are
+    // branch free loops over contiguous arrays, which the compiler vectorizes.
+    template <typename CostType, typename IndexType = std::uint32_t> class DenseAssignment
+    {
+        public:
+            typedef std::size_t NodeId;
+            static constexpr IndexType none = std::numeric_limits<IndexType>::max();
+
+            DenseAssignment() {}
+            DenseAssignment(std::size_t no_rows, std::size_t no_cols) { reset(no_rows, no_cols); }
+            // cost is row-major, entry i*no_cols + j is the cost of assigning row i to column j
+            DenseAssignment(std::size_t no_rows, std::size_t no_cols, const std::vector<CostType>& cost);
+
+            // set the dimension, all costs to zero and remove the assignment, keeping allocated buffers
+            void reset(std::size_t no_rows, std::size_t no_cols);
+
+            CostType& cost(const std::size_t i, const std::size_t j) { assert(i < rowNum && j < colNum); return costs[i*colNum + j]; }
+            CostType cost(const std::size_t i, const std::size_t j) const { assert(i < rowNum && j < colNum); return costs[i*colNum + j]; }
+
+            // assign all rows, starting from scratch. Returns the objective
+            CostType solve();
+            CostType objective() const;
+
+            std::size_t no_rows() const { return rowNum; }
+            std::size_t no_cols() const { return colNum; }
+            // column of row i resp. row of column j, none if unassigned
+            IndexType col(const std::size_t i) const { assert(i < rowNum); return colOfRow[i]; }
+            IndexType row(const std::size_t j) const { assert(j < colNum); return rowOfCol[j]; }
+            // potential with the conventions of SSP: cost(i,j) + potential(no_rows + j) - potential(i) is non-negative
+            // for all pairs and zero for assigned ones
+            CostType potential(const NodeId i) const { assert(i < rowNum + colNum); return i < rowNum ? rowPi[i] : colPi[i - rowNum]; }
+            CostType reduced_cost(const std::size_t i, const std::size_t j) const { return cost(i,j) + colPi[j] - rowPi[i]; }
+
+            // debug function
+            bool TestOptimality() const;
+
+        private:
+            std::size_t rowNum = 0, colNum = 0;
+            std::vector<CostType> costs;
+            std::vector<CostType> rowPi, colPi;
+            std::vector<IndexType> colOfRow, rowOfCol;
+
+            // per augmentation: distance and predecessor row of every column, scanned rows and columns
+            std::vector<CostType> shortest;
+            std::vector<IndexType> pred;
+            std::vector<CostType> closed; // Infinity() for scanned columns, 0 otherwise. Added to distances instead of branching
+
+            // larger than all distances. For integers half the maximum, so that adding closed does not overflow
+            static CostType Infinity()
+            {
+                return std::numeric_limits<CostType>::has_infinity ? std::numeric_limits<CostType>::infinity() : std::numeric_limits<CostType>::max()/2;
+            }
+            std::vector<IndexType> scannedRows, scannedCols;
+
+            void Augment(const std::size_t s);
+    };
+
+    template <typename CostType, typename IndexType>
+        constexpr IndexType DenseAssignment<CostType, IndexType>::none;
+
+    template <typename CostType, typename IndexType>
+        DenseAssignment<CostType, IndexType>::DenseAssignment(std::size_t no_rows, std::size_t no_cols, const std::vector<CostType>& cost)
+        {
+            if (cost.size() != no_rows*no_cols) { throw std::invalid_argument("MCF::DenseAssignment: cost matrix must have no_rows*no_cols entries"); }
+            reset(no_rows, no_cols);
+            std::copy(cost.begin(), cost.end(), costs.begin());
+        }
+
+    template <typename CostType, typename IndexType>
+        inline void DenseAssignment<CostType, IndexType>::reset(std::size_t no_rows, std::size_t no_cols)
+        {
+            if (no_rows > no_cols) { throw std::invalid_argument("MCF::DenseAssignment: more rows than columns"); }
+            if (no_cols >= none) { throw std::length_error("MCF::DenseAssignment: number of columns exceeds the range of the index type"); }
+            rowNum = no_rows;
+            colNum = no_cols;
+            costs.assign(rowNum*colNum, 0);
+            rowPi.assign(rowNum, 0);
+            colPi.assign(colNum, 0);
+            colOfRow.assign(rowNum, none);
+            rowOfCol.assign(colNum, none);
+        }
+
+    template <typename CostType, typename IndexType>
+        inline CostType DenseAssignment<CostType, IndexType>::solve()
+        {
+            std::fill(rowPi.begin(), rowPi.end(), 0);
+            std::fill(colPi.begin(), colPi.end(), 0);
+            std::fill(colOfRow.begin(), colOfRow.end(), none);
+            std::fill(rowOfCol.begin(), rowOfCol.end(), none);
+            shortest.resize(colNum);
+            pred.resize(colNum);
+            closed.resize(colNum);
+
+            for (std::size_t s=0; s<rowNum; ++s) { Augment(s); }
+
+            assert(TestOptimality());
+            return objective();
+        }
+
+    // Dijkstra from row s over reduced costs until an unassigned column is reached, then augment along the
+    // shortest path. Rows are only entered through their assigned column, hence scanning a row relaxes all columns.
+    template <typename CostType, typename IndexType>
+        inline void DenseAssignment<CostType, IndexType>::Augment(const std::size_t s)
+        {
+            const CostType infinity = Infinity();
+            const std::size_t n = colNum;
+            std::fill(shortest.begin(), shortest.end(), infinity);
+            std::fill(closed.begin(), closed.end(), CostType(0));
+            scannedRows.clear();
+            scannedCols.clear();
+
+            CostType d = 0; // distance of the row being scanned
+            std::size_t i = s;
+            std::size_t sink;
+            for (;;)
+            {
+                scannedRows.push_back(i);
+                const CostType* c = &costs[i*n];
+                const CostType h = d - rowPi[i];
+                CostType* const dist = shortest.data();
+                IndexType* const p = pred.data();
+                const CostType* const mask = closed.data();
+                const CostType* const pi = colPi.data();
+                // reduced costs are non-negative, hence r >= d and scanned columns with dist[j] <= d are never improved
+                for (std::size_t j=0; j<n; ++j)
+                {
+                    const CostType r = h + c[j] + pi[j];
+                    const bool better = r + mask[j] < dist[j];
+                    dist[j] = better ? r : dist[j];
+                    p[j] = better ? IndexType(i) : p[j];
+                }
+
+                CostType min_dist = infinity;
+                for (std::size_t j=0; j<n; ++j)
+                {
+                    const CostType r = dist[j] + mask[j];
+                    min_dist = r < min_dist ? r : min_dist;
+                }
+                // among the closest columns prefer an unassigned one, which ends the search
+                std::size_t next = n;
+                for (std::size_t j=0; j<n; ++j)
+                {
+                    if (mask[j] == 0 && dist[j] == min_dist)
+                    {
+                        if (next == n) { next = j; }
+                        if (rowOfCol[j] == none) { next = j; break; }
+                    }
+                }
+                assert(next < n);
+
+                d = min_dist;
+                closed[next] = infinity;
+                scannedCols.push_back(next);
+                if (rowOfCol[next] == none) { sink = next; break; }
+                i = rowOfCol[next];
+            }
+
+            // update potentials so that reduced costs stay non-negative and become zero along the path
+            rowPi[s] += d;
+            for (std::size_t k=1; k<scannedRows.size(); ++k)
+            {
+                const std::size_t r = scannedRows[k];
+                rowPi[r] += d - shortest[colOfRow[r]];
+            }
+            for (const std::size_t j : scannedCols) { colPi[j] += d - shortest[j]; }
+
+            // augment: every row on the path takes the column it was reached from
+            for (std::size_t j=sink;;)
+            {
+                const std::size_t r = pred[j];
+                const std::size_t previous = colOfRow[r];
+                rowOfCol[j] = r;
+                colOfRow[r] = j;
+                if (r == s) { break; }
+                j = previous;
+            }
+        }
+
+    template <typename CostType, typename IndexType>
+        inline CostType DenseAssignment<CostType, IndexType>::objective() const
+        {
+            CostType c = 0;
+            for (std::size_t i=0; i<rowNum; ++i)
+            {
+                if (colOfRow[i] != none) { c += cost(i, colOfRow[i]); }
+            }
+            return c;
+        }
+
+    template <typename CostType, typename IndexType>
+        bool DenseAssignment<CostType, IndexType>::TestOptimality() const
+        {
+            const CostType eps = std::is_floating_point<CostType>::value ? CostType(1e-8) : CostType(0);
+            for (std::size_t i=0; i<rowNum; ++i)
+            {
+                if (colOfRow[i] == none || rowOfCol[colOfRow[i]] != i) { return false; }
+                for (std::size_t j=0; j<colNum; ++j)
+                {
+                    if (reduced_cost(i,j) < -eps*(1 + std::abs(cost(i,j)))) { return false; }
+                }
+                if (std::abs(reduced_cost(i, colOfRow[i])) > eps*(1 + std::abs(cost(i, colOfRow[i])))) { return false; }
+            }
+            // with a common sink behind all columns, unassigned columns must not have larger potential than assigned ones
+            CostType max_unassigned = std::numeric_limits<CostType>::lowest();
+            CostType min_assigned = std::numeric_limits<CostType>::max();
+            for (std::size_t j=0; j<colNum; ++j)
+            {
+                if (rowOfCol[j] == none) { max_unassigned = std::max(max_unassigned, colPi[j]); }
+                else { min_assigned = std::min(min_assigned, colPi[j]); }
+            }
+            return rowNum == colNum || rowNum == 0 || max_unassigned <= min_assigned + eps*(1 + std::abs(min_assigned));
+        }
+
+    // assign every row of the row-major no_rows x no_cols cost matrix to a distinct column. Returns the column of
+    // every row, the objective is stored in objective if given.
+    template <typename CostType>
+        std::vector<std::size_t> solve_assignment(const std::vector<CostType>& cost, const std::size_t no_rows, const std::size_t no_cols, CostType* objective = nullptr)
+        {
+            DenseAssignment<CostType> a(no_rows, no_cols, cost);
+            const CostType c = a.solve();
+            if (objective != nullptr) { *objective = c; }
+            std::vector<std::size_t> col(no_rows);
+            for (std::size_t i=0; i<no_rows; ++i) { col[i] = a.col(i); }
+            return col;
+        }
+
+} // namespace MCF
+
+#undef SSP_STAT
 
 #endif // MCF_SSP_HXX
@@ -0,0 +1,143 @@
+#include "../mcf_ssp.hxx"
+#include "test.h"
+#include <random>
+#include <vector>
+
+using namespace MCF;
+
+// 3x3 assignment problems as in assignment_problem.cpp
+BatchProblem<long,long> assignment_problem(std::mt19937& rng)
+{
+   std::uniform_int_distribution<long> uni(0,10);
+   BatchProblem<long,long> p;
+   p.no_nodes = 6;
+   for(int i=0; i<3; ++i) {
+      for(int j=0; j<3; ++j) {
+         p.tails.push_back(i);
+         p.heads.push_back(3+j);
+         p.lower.push_back(0);
+         p.upper.push_back(1);
+         p.cost.push_back(uni(rng));
+      }
+   }
+   p.excess = {1,1,1,-1,-1,-1};
+   return p;
+}
+
+int main()
+{
+   std::mt19937 rng(0);
+   std::vector<BatchProblem<long,long>> problems;
+   for(int run=0; run<1000; ++run) {
+      problems.push_back(assignment_problem(rng));
+   }
+   // problems of different size, so that reset() has to grow buffers
+   for(int run=0; run<10; ++run) {
+      std::uniform_int_distribution<std::size_t> node(0, 49);
+      std::uniform_int_distribution<long> cost(-10, 100);
+      BatchProblem<long,long> p;
+      p.no_nodes = 50;
+      p.excess.assign(50, 0);
+      for(int e=0; e<200+100*run; ++e) {
+         const std::size_t i = node(rng);
+         const std::size_t j = (i + 1 + node(rng)%49)%50;
+         p.tails.push_back(i);
+         p.heads.push_back(j);
+         p.lower.push_back(0);
+         p.upper.push_back(5);
+         p.cost.push_back(cost(rng));
+      }
+      p.excess[node(rng)] += 5;
+      p.excess[node(rng)] -= 5;
+      problems.push_back(p);
+   }
+
+   // reference solutions from freshly constructed solvers
+   std::vector<long> objective;
+   for(const auto& p : problems) {
+      SSP<long,long> mcf(p.no_nodes, p.tails.size());
+      for(std::size_t e=0; e<p.tails.size(); ++e) {
+         mcf.add_edge(p.tails[e], p.heads[e], p.lower[e], p.upper[e], p.cost[e]);
+      }
+      for(std::size_t i=0; i<p.no_nodes; ++i) {
+         mcf.add_node_excess(i, p.excess[i]);
+      }
+      objective.push_back(mcf.solve());
+   }
+
+   // one solver reused through reset(), large problems first so that buffers shrink logically
+   SSP<long,long> mcf;
+   for(std::size_t k=problems.size(); k-- > 0; ) {
+      const auto& p = problems[k];
+      mcf.reset(p.no_nodes, p.tails.size());
+      test(mcf.no_nodes() == p.no_nodes);
+      test(mcf.no_edges() == 0);
+      test(mcf.objective() == 0);
+      mcf.add_edges(p.tails, p.heads, p.lower, p.upper, p.cost);
+      for(std::size_t i=0; i<p.no_nodes; ++i) {
+         mcf.add_node_excess(i, p.excess[i]);
+      }
+      test(mcf.solve() == objective[k]);
+      test(mcf.TestOptimality());
+   }
+
+   // clear() keeps the number of nodes
+   mcf.clear();
+   test(mcf.no_nodes() == problems[0].no_nodes);
+   test(mcf.no_edges() == 0);
+
+   // flows are feasible and have the reference objective
+   auto check = [&](const std::vector<BatchSolution<long,long>>& solutions, const std::size_t first) {
+      for(std::size_t s=0; s<solutions.size(); ++s) {
+         const std::size_t k = first + s;
+         test(solutions[s].objective == objective[k]);
+         long c = 0;
+         std::vector<long> excess = problems[k].excess;
+         for(std::size_t e=0; e<problems[k].tails.size(); ++e) {
+            const long f = solutions[s].flow[e];
+            test(f >= problems[k].lower[e] && f <= problems[k].upper[e]);
+            c += f*problems[k].cost[e];
+            excess[problems[k].tails[e]] -= f;
+            excess[problems[k].heads[e]] += f;
+         }
+         test(c == objective[k]);
+         test(std::all_of(excess.begin(), excess.end(), [](const long x) { return x == 0; }));
+      }
+   };
+
+   for(const std::size_t no_threads : {1, 3, 8}) {
+      double problems_per_second = 0.0;
+      const auto solutions = solve_batch(problems, no_threads, &problems_per_second);
+      std::cout << no_threads << " threads: " << problems_per_second << " problems/second\n";
+      test(solutions.size() == problems.size());
+      check(solutions, 0);
+   }
+
+   test(solve_batch(std::vector<BatchProblem<long,long>>()).empty());
+
+   // one pool for many small batches, including empty ones and ones with fewer problems than threads
+   BatchSolver<long,long> pool(3);
+   test(pool.no_threads() == 3);
+   for(std::size_t first=0; first<problems.size(); first+=first%3+1) {
+      const std::size_t last = std::min(problems.size(), first + first%5);
+      const std::vector<BatchProblem<long,long>> batch(problems.begin()+first, problems.begin()+last);
+      const auto solutions = pool.solve(batch);
+      test(solutions.size() == batch.size());
+      check(solutions, first);
+   }
+
+   // an exception of one problem is rethrown after the batch and the pool can still be used
+   BatchSolver<long,long,BinaryHeap,std::uint8_t> small_pool(3);
+   std::vector<BatchProblem<long,long>> batch(problems.begin(), problems.begin()+100);
+   batch[50].no_nodes = 300;
+   batch[50].excess.assign(300, 0);
+   bool thrown = false;
+   try {
+      small_pool.solve(batch);
+   } catch(const std::length_error&) {
+      thrown = true;
+   }
+   test(thrown);
+   batch[50] = problems[50];
+   check(small_pool.solve(batch), 0);
+}
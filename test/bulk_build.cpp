@@ -0,0 +1,127 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+#include <random>
+#include <vector>
+
+using namespace MCF;
+
+// edges of a problem, in the order they are added
+typedef BatchProblem<long,long> edges;
+
+edges random_edges(const std::size_t n, const std::size_t m, std::mt19937& rng)
+{
+   std::uniform_int_distribution<std::size_t> node(0, n-1);
+   std::uniform_int_distribution<long> cost(-10, 100);
+   std::uniform_int_distribution<long> capacity(1, 10);
+   edges g;
+   g.no_nodes = n;
+   g.excess.assign(n, 0);
+   while(g.tails.size() < m) {
+      // parallel arcs are frequent, so that ties in the sort are exercised
+      const std::size_t i = node(rng);
+      const std::size_t j = (i + 1 + node(rng)%std::min(n-1, std::size_t(4)))%n;
+      g.tails.push_back(i);
+      g.heads.push_back(j);
+      g.lower.push_back(0);
+      g.upper.push_back(capacity(rng));
+      g.cost.push_back(cost(rng));
+   }
+   // excesses of a feasible flow within the bounds, so that the problem is feasible
+   for(std::size_t e=0; e<m; ++e) {
+      const long f = std::uniform_int_distribution<long>(g.lower[e], g.upper[e])(rng);
+      g.excess[g.tails[e]] += f;
+      g.excess[g.heads[e]] -= f;
+   }
+   return g;
+}
+
+// build() must give the same arc layout as add_edge() followed by order()
+void test_build(const edges& g)
+{
+   SSP<long,long> reference(g.no_nodes, g.tails.size());
+   for(std::size_t e=0; e<g.tails.size(); ++e) {
+      reference.add_edge(g.tails[e], g.heads[e], g.lower[e], g.upper[e], g.cost[e]);
+      test(reference.edge_arc(e) == 2*e);
+   }
+   for(std::size_t i=0; i<g.no_nodes; ++i) { reference.add_node_excess(i, g.excess[i]); }
+   reference.order();
+   const long objective = reference.solve();
+
+   for(const std::size_t no_threads : {0, 1, 3}) {
+      SSP<long,long> mcf(g.no_nodes, g.tails.size());
+      mcf.build(g.tails, g.heads, g.lower, g.upper, g.cost, no_threads);
+      for(std::size_t i=0; i<g.no_nodes; ++i) { mcf.add_node_excess(i, g.excess[i]); }
+      test(mcf.no_edges() == g.tails.size());
+      for(std::size_t a=0; a<mcf.no_arcs(); ++a) {
+         test(mcf.tail(a) == reference.tail(a));
+         test(mcf.head(a) == reference.head(a));
+         test(mcf.cost(a) == reference.cost(a));
+         test(a == 0 || mcf.tail(a-1) < mcf.tail(a) || (mcf.tail(a-1) == mcf.tail(a) && mcf.head(a-1) <= mcf.head(a)));
+      }
+      for(std::size_t e=0; e<g.tails.size(); ++e) {
+         const std::size_t a = mcf.edge_arc(e);
+         test(a == reference.edge_arc(e));
+         test(mcf.tail(a) == g.tails[e] && mcf.head(a) == g.heads[e] && mcf.cost(a) == g.cost[e]);
+         test(mcf.upper_bound(a) == g.upper[e] && mcf.lower_bound(a) == g.lower[e]);
+      }
+
+      test(mcf.solve() == objective);
+      test(mcf.TestOptimality());
+      for(std::size_t e=0; e<g.tails.size(); ++e) {
+         test(mcf.flow(mcf.edge_arc(e)) == reference.flow(reference.edge_arc(e)));
+      }
+
+      // reordering again and adding edges later keeps the mapping
+      if(g.tails.size() > 0) {
+         mcf.reset(g.no_nodes, g.tails.size());
+         mcf.build(g.tails, g.heads, g.lower, g.upper, g.cost, no_threads);
+         mcf.order(no_threads);
+         for(std::size_t e=0; e<g.tails.size(); ++e) { test(mcf.edge_arc(e) == reference.edge_arc(e)); }
+      }
+   }
+}
+
+int main()
+{
+   std::mt19937 rng(0);
+   for(int run=0; run<20; ++run) {
+      test_build(random_edges(2 + rng()%50, rng()%500, rng));
+   }
+   test_build(random_edges(1000, 100000, rng));
+
+   for(auto e : gte) {
+      std::cout << "testing " << e.file << "\n";
+      const edges g = read_dimacs_problem(e.file);
+      test_build(g);
+      SSP<long,long> mcf(g.no_nodes, g.tails.size());
+      mcf.build(g.tails, g.heads, g.lower, g.upper, g.cost);
+      for(std::size_t i=0; i<g.no_nodes; ++i) { mcf.add_node_excess(i, g.excess[i]); }
+      test(mcf.solve() == e.objective);
+   }
+
+   // edges added after order() are found at 2*e
+   SSP<long,long> mcf(4, 4);
+   mcf.add_edge(2, 3, 0, 1, 1);
+   mcf.add_edge(0, 1, 0, 1, 1);
+   mcf.order();
+   test(mcf.edge_arc(0) == 2 && mcf.edge_arc(1) == 0);
+   mcf.add_edge(1, 2, 0, 1, 1);
+   test(mcf.edge_arc(2) == 4 && mcf.tail(4) == 1);
+   mcf.order();
+   test(mcf.tail(mcf.edge_arc(0)) == 2 && mcf.tail(mcf.edge_arc(1)) == 0 && mcf.tail(mcf.edge_arc(2)) == 1);
+
+   // exceptions thrown by worker threads are passed to the caller after all shares are done
+   std::vector<int> done(4, 0);
+   bool thrown = false;
+   try {
+      run_parallel(4, [&](const std::size_t t) {
+         done[t] = 1;
+         if(t >= 2) { throw std::runtime_error("share " + std::to_string(t)); }
+      });
+   } catch(const std::runtime_error& e) {
+      thrown = std::string(e.what()) == "share 2";
+   }
+   test(thrown);
+   test(std::all_of(done.begin(), done.end(), [](const int x) { return x == 1; }));
+}
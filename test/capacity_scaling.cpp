@@ -0,0 +1,56 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+#include <random>
+
+using namespace MCF;
+
+int main()
+{
+  // random networks with negative costs and large capacities. A ring of expensive arcs keeps them feasible.
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<long> node(0,29);
+  std::uniform_int_distribution<long> cap(1,100000);
+  std::uniform_int_distribution<long> cost(-50,100);
+  for(int run=0; run<100; ++run) {
+    const int num_nodes = 30;
+    const int num_arcs = 150;
+    SSP<long,long> mcf(num_nodes, num_arcs + num_nodes);
+    for(int i=0; i<num_nodes; ++i) {
+      mcf.add_edge(i, (i+1)%num_nodes, 0, 10000000, 1000);
+    }
+    for(int e=0; e<num_arcs; ++e) {
+      const long i = node(rng);
+      const long j = node(rng);
+      if(i == j) continue;
+      mcf.add_edge(i, j, 0, cap(rng), cost(rng));
+    }
+    for(int i=0; i<num_nodes/2; ++i) {
+      const long b = cap(rng);
+      mcf.add_node_excess(i, b);
+      mcf.add_node_excess(num_nodes-1-i, -b);
+    }
+
+    SSP<long,long> mcf_scaling(mcf);
+    const long obj = mcf.solve();
+    test(mcf_scaling.solve_capacity_scaling() == obj);
+    test(mcf_scaling.objective() == obj);
+    test(mcf_scaling.TestOptimality());
+  }
+
+  // fractional capacities and excesses: the ordinary algorithm and the last scaling phase must not require a unit of flow
+  for(int variant=0; variant<3; ++variant) {
+    SSP<double,double> mcf(3, 3);
+    mcf.add_edge(0, 1, 0, 0.5, 1);
+    mcf.add_edge(1, 2, 0, 0.5, 0);
+    mcf.add_edge(0, 2, 0, 0.5, 2);
+    mcf.add_node_excess(0, 0.75);
+    mcf.add_node_excess(2, -0.75);
+    const double obj = variant == 0 ? mcf.solve() : variant == 1 ? mcf.resolve() : mcf.solve_capacity_scaling();
+    test(obj == 1.0);
+    test(mcf.objective() == 1.0);
+    test(mcf.flow(0) == 0.5 && mcf.flow(2) == 0.5 && mcf.flow(4) == 0.25);
+  }
+
+  test_instances(gte, [](auto& f) { return f.solve_capacity_scaling(); });
+}
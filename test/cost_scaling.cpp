@@ -0,0 +1,87 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+#include <random>
+
+using namespace MCF;
+
+// network with planted feasible flow and large capacities, random costs including negative ones
+SSP<long,long> random_network(const std::size_t n, const std::size_t m, std::mt19937& rng)
+{
+  std::uniform_int_distribution<std::size_t> node(0, n-1);
+  std::uniform_int_distribution<long> cost(-100, 1000);
+  std::uniform_int_distribution<long> capacity(1, 100000);
+  SSP<long,long> mcf(n, m);
+  std::vector<long> excess(n, 0);
+  while(mcf.no_edges() < m) {
+    const std::size_t i = node(rng);
+    const std::size_t j = node(rng);
+    if(i == j) continue;
+    const long upper = capacity(rng);
+    const long f = rng()%(upper+1);
+    mcf.add_edge(i, j, 0, upper, cost(rng));
+    excess[i] += f;
+    excess[j] -= f;
+  }
+  for(std::size_t i=0; i<n; ++i) { mcf.add_node_excess(i, excess[i]); }
+  return mcf;
+}
+
+int main()
+{
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<long> uni(0,100);
+
+  test_assignment_problems(rng, [](SSP<long,long>& f) { return f.solve_cost_scaling(); });
+
+  // networks with large flow values, against all other algorithms and with different scaling factors
+  for(int run=0; run<10; ++run) {
+    SSP<long,long> mcf = random_network(200, 2000, rng);
+    SSP<long,long> reference(mcf);
+    const long obj = reference.solve();
+    for(const Algorithm algorithm : {Algorithm::successive_shortest_path_csr, Algorithm::capacity_scaling, Algorithm::primal_dual, Algorithm::cost_scaling}) {
+      SSP<long,long> f(mcf);
+      test(f.solve(algorithm) == obj);
+      test(f.objective() == obj);
+      test(f.TestOptimality());
+    }
+    for(const long alpha : {2, 5, 100}) {
+      SSP<long,long> f(mcf);
+      test(f.solve_cost_scaling(alpha) == obj);
+      test(f.TestOptimality());
+    }
+
+    // solving again after changing costs
+    SSP<long,long> f(mcf);
+    f.solve_cost_scaling();
+    reference = mcf;
+    for(std::size_t e=0; e<mcf.no_edges(); e+=7) {
+      f.update_cost(2*e, 50);
+      reference.update_cost(2*e, 50);
+    }
+    const long updated_obj = reference.solve();
+    test(f.solve_cost_scaling() == updated_obj);
+    test(f.objective() == updated_obj);
+    test(f.TestOptimality());
+  }
+
+  // floating point costs
+  for(int run=0; run<10; ++run) {
+    std::uniform_real_distribution<double> cost(-1.0, 10.0);
+    const int n = 30;
+    SSP<long,double> mcf(2*n, n*n);
+    for(int i=0; i<n; ++i) {
+      for(int j=0; j<n; ++j) {
+        mcf.add_edge(i, n+j, 0, 1 + uni(rng), cost(rng));
+      }
+      mcf.add_node_excess(i, 20);
+      mcf.add_node_excess(n+i, -20);
+    }
+    SSP<long,double> mcf_cs(mcf);
+    const double obj = mcf.solve();
+    test(std::abs(mcf_cs.solve_cost_scaling() - obj) < 1e-6);
+    test(mcf_cs.TestOptimality());
+  }
+
+  test_instances(gte, [](auto& f) { return f.solve_cost_scaling(); });
+}
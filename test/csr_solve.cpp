@@ -0,0 +1,38 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+
+using namespace MCF;
+
+int main()
+{
+  SSP<long,long> mcf(6, 8);
+  mcf.add_edge( 0, 1, 0, 4, 1);
+  mcf.add_edge( 0, 2, 0, 8, 5);
+  mcf.add_edge( 1, 2, 0, 5, 0);
+  mcf.add_edge( 2, 4, 0, 10, 1);
+  mcf.add_edge( 3, 1, 0, 8, 1);
+  mcf.add_edge( 3, 5, 0, 8, 1);
+  mcf.add_edge( 4, 3, 0, 8, 0);
+  mcf.add_edge( 4, 5, 0, 8, 9);
+  mcf.add_node_excess( 0, 10);
+  mcf.add_node_excess( 5, -10);
+
+  // arcs need not be ordered for the frozen layout
+  test(mcf.solve_csr() == 70);
+  test(mcf.objective() == 70);
+  test(mcf.TestOptimality());
+
+  // arcs stay usable with the linked list based solver afterwards
+  mcf.update_cost(0, 10);
+  test(mcf.solve() == mcf.objective());
+  test(mcf.TestOptimality());
+
+  test_instances(gte, [](auto& f) {
+    const auto objective = f.solve_csr();
+    for(std::size_t e=0; e<f.no_arcs(); ++e) {
+      test(f.residual_capacity(e) == 0 || f.reduced_cost(e) >= -1e-5);
+    }
+    return objective;
+  });
+}
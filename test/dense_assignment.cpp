@@ -0,0 +1,127 @@
+#include "../mcf_ssp.hxx"
+#include "test.h"
+#include <random>
+#include <vector>
+
+using namespace MCF;
+
+// objective of the assignment problem solved by SSP on the bipartite graph
+template<typename CostType>
+CostType ssp_objective(const std::vector<CostType>& cost, const std::size_t n)
+{
+   SSP<long,CostType> mcf(2*n, n*n);
+   for(std::size_t i=0; i<n; ++i) {
+      for(std::size_t j=0; j<n; ++j) {
+         mcf.add_edge(i, n+j, 0, 1, cost[i*n+j]);
+      }
+   }
+   for(std::size_t i=0; i<n; ++i) {
+      mcf.add_node_excess(i, 1);
+      mcf.add_node_excess(n+i, -1);
+   }
+   mcf.order();
+   return mcf.solve();
+}
+
+// smallest cost of assigning rows to distinct columns by enumeration
+long brute_force(const std::vector<long>& cost, const std::size_t no_rows, const std::size_t no_cols)
+{
+   std::vector<std::size_t> cols(no_cols);
+   std::iota(cols.begin(), cols.end(), 0);
+   long best = std::numeric_limits<long>::max();
+   do {
+      long c = 0;
+      for(std::size_t i=0; i<no_rows; ++i) { c += cost[i*no_cols + cols[i]]; }
+      best = std::min(best, c);
+   } while(std::next_permutation(cols.begin(), cols.end()));
+   return best;
+}
+
+template<typename CostType>
+void test_assignment(const DenseAssignment<CostType>& a, const CostType objective)
+{
+   test(a.TestOptimality());
+   std::vector<bool> used(a.no_cols(), false);
+   CostType c = 0;
+   for(std::size_t i=0; i<a.no_rows(); ++i) {
+      const std::size_t j = a.col(i);
+      test(j < a.no_cols());
+      test(!used[j]);
+      test(a.row(j) == i);
+      used[j] = true;
+      c += a.cost(i,j);
+   }
+   test(c == a.objective());
+   test(c == objective);
+}
+
+int main()
+{
+   std::mt19937 rng(0);
+
+   // square problems against SSP, including negative costs and many ties
+   for(const std::size_t n : {1, 2, 3, 10, 50, 200}) {
+      for(const long max_cost : {2l, 10l, 1000l}) {
+         std::uniform_int_distribution<long> uni(-max_cost/2, max_cost);
+         std::vector<long> cost(n*n);
+         for(auto& c : cost) { c = uni(rng); }
+         DenseAssignment<long> a(n, n, cost);
+         const long objective = a.solve();
+         test_assignment(a, ssp_objective(cost, n));
+         test(objective == a.objective());
+
+         long c = 0;
+         const auto col = solve_assignment(cost, n, n, &c);
+         test(c == objective);
+         for(std::size_t i=0; i<n; ++i) { test(col[i] == a.col(i)); }
+      }
+   }
+
+   // rectangular problems against enumeration
+   for(int run=0; run<200; ++run) {
+      const std::size_t no_rows = 1 + rng()%4;
+      const std::size_t no_cols = no_rows + rng()%3;
+      std::uniform_int_distribution<long> uni(-5, 20);
+      std::vector<long> cost(no_rows*no_cols);
+      for(auto& c : cost) { c = uni(rng); }
+      DenseAssignment<long> a(no_rows, no_cols, cost);
+      a.solve();
+      test_assignment(a, brute_force(cost, no_rows, no_cols));
+   }
+
+   // floating point costs
+   for(const std::size_t n : {5, 100}) {
+      std::uniform_real_distribution<double> uni(0.0, 1.0);
+      DenseAssignment<double> a(n, n);
+      for(std::size_t i=0; i<n; ++i) {
+         for(std::size_t j=0; j<n; ++j) { a.cost(i,j) = uni(rng); }
+      }
+      std::vector<double> cost(n*n);
+      for(std::size_t i=0; i<n; ++i) {
+         for(std::size_t j=0; j<n; ++j) { cost[i*n+j] = a.cost(i,j); }
+      }
+      a.solve();
+      test(a.TestOptimality());
+      test(std::abs(a.objective() - ssp_objective(cost, n)) < 1e-8);
+   }
+
+   // reuse through reset()
+   DenseAssignment<long> a;
+   for(const std::size_t n : {30, 5, 60}) {
+      a.reset(n, n);
+      std::vector<long> cost(n*n);
+      for(std::size_t i=0; i<n; ++i) {
+         for(std::size_t j=0; j<n; ++j) { a.cost(i,j) = cost[i*n+j] = rng()%100; }
+      }
+      test_assignment(a, a.solve());
+      test(a.objective() == ssp_objective(cost, n));
+   }
+
+   bool thrown = false;
+   try {
+      DenseAssignment<long> b(3, 2);
+   } catch(const std::invalid_argument&) {
+      thrown = true;
+   }
+   test(thrown);
+}
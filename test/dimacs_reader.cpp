@@ -0,0 +1,80 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+
+using namespace MCF;
+
+const std::string filename = "dimacs_reader_test.min";
+
+// check that reading the given file content fails with a message mentioning the given line
+template<typename FLOW_TYPE = long>
+void test_error(const std::string& content, const std::size_t line, const std::size_t no_threads = 0)
+{
+  { std::ofstream f(filename); f << content; }
+  bool thrown = false;
+  try {
+    load_dimacs_file<FLOW_TYPE,long>(filename, no_threads);
+  } catch(const std::runtime_error& e) {
+    thrown = true;
+    std::cout << e.what() << "\n";
+    test(std::string(e.what()).find("line " + std::to_string(line) + ":") != std::string::npos);
+  }
+  test(thrown);
+  std::remove(filename.c_str());
+}
+
+int main()
+{
+  for(auto e : gte) {
+    std::cout << "testing " << e.file << "\n";
+    for(std::size_t no_threads : {1, 3, 16}) {
+      auto f = load_dimacs_file<int,long>(e.file, no_threads);
+      test(f.no_nodes() == 49);
+      test(f.no_edges() == 520);
+      test(f.solve() == e.objective);
+      test(f.TestOptimality());
+    }
+    auto g = load_dimacs_file<int,double>(e.file, 2);
+    test(g.solve() == e.objective);
+  }
+
+  test_error("c comment\nn 1 1\np min 2 1\n", 2);
+  test_error("p min 2 1\np min 2 1\n", 2);
+  test_error("p min 2 1\nn 1 1\nn 2 -1\nc\na 1 2 0 x 1\n", 5);
+  test_error("p min 2 1\n\na 1 3 0 1 1\n", 3);
+  test_error("p min 2 1\na 1 2 0 1 1\na 2 1 0 1 1\n", 3);
+  test_error("p min 2 1\nn 1 1\nx\n", 3);
+  test_error("p max 2 1\n", 1);
+
+  // errors in several chunks parsed in parallel: all threads finish and the first error is reported
+  {
+    std::string content = "p min 100 100\n";
+    for(int k=0; k<100; ++k) {
+      content += (k == 40 || k == 90) ? "a 1 1 0 1 1\n" : "a 1 2 0 1 1\n";
+    }
+    test_error(content, 42, 4);
+  }
+
+  // numbers that do not fit into the flow or cost type
+  test_error("p min 2 1\nn 1 1\nn 2 -1\na 1 2 0 99999999999999999999 1\n", 4);
+  test_error("p min 2 1\nn 1 1\nn 2 -1\na 1 2 0 1 -9223372036854775809\n", 4);
+  test_error<int>("p min 2 1\nn 1 1\nn 2 -1\na 1 2 0 3000000000 1\n", 4);
+  test_error<int>("p min 2 1\nn 1 -2147483649\n", 2);
+  test_error<unsigned>("p min 2 1\nn 1 1\nn 2 -1\n", 3);
+
+  // extreme integers and decimal numbers are read exactly as by strtol and strtod
+  {
+    { std::ofstream f(filename); f << "p min 2 1\nn 1 1\nn 2 -1\na 1 2 0 1 -9223372036854775808\n"; }
+    auto f = load_dimacs_file<int,long>(filename);
+    test(f.cost(f.edge_arc(0)) == std::numeric_limits<long>::min());
+  }
+  for(const std::string c : {"0.3", "-0.7", "1.5e2", "2.5E-3", ".125", "123456789.123456789", "7"}) {
+    { std::ofstream f(filename); f << "p min 2 1\nn 1 1\nn 2 -1\na 1 2 0 1 " << c << "\n"; }
+    auto f = load_dimacs_file<double,double>(filename);
+    test(f.cost(f.edge_arc(0)) == std::strtod(c.c_str(), nullptr));
+    auto g = load_dimacs_file<float,float>(filename);
+    test(g.cost(g.edge_arc(0)) == std::strtof(c.c_str(), nullptr));
+  }
+  test_error("p min 2 1\nn 1 1\nn 2 -1\na 1 2 0 1 0.3.5\n", 4);
+  std::remove(filename.c_str());
+}
@@ -1,93 +1,109 @@
-#include "catch.hpp"
-#include "../mcmf.hxx"
+#include "../mcf_ssp.hxx"
+#include "test.h"
 #include <random>
 
+using namespace MCF;
 
-using namespace CS2_CPP;
+int main()
+{
+   std::mt19937 rng(0);
+   std::uniform_int_distribution<long> uni(0,10000);
+   // build assignment problems and change costs and capacities after having found a solution
 
-TEST_CASE( "dynamic problem", "[dynamic]" ) {
-   std::random_device rd;     // only used once to initialise (seed) engine
-   std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-   std::uniform_int_distribution<long> uni(0,10000); // guaranteed unbiased
-   // build assignment problems and change cost after having found a solution
+   // cost update
+   for(int run =0; run<100; ++run) {
+      const int num_nodes = 6;
+      const int num_arcs = 9;
+      SSP<long,long> mcf( num_nodes, num_arcs);
 
-   /*
-   SECTION( "cost update" ) {
-      for(int run =0; run<100; ++run) {
-         const int num_nodes = 6;
-         const int num_arcs = 9;
-         MCMF_CS2_STAT<> mcf( num_nodes, num_arcs);
-
-         for(int i=0; i<3; ++i) {
-            for(int j=0; j<3; ++j) {
-               mcf.set_arc(i,3+j,0,1,uni(rng));
-            }
-         }
-         for(int i=0; i<3; ++i) {
-            mcf.set_excess(i,1);
-            mcf.set_excess(3+i,-1);
+      for(int i=0; i<3; ++i) {
+         for(int j=0; j<3; ++j) {
+            mcf.add_edge(i,3+j,0,1,uni(rng));
          }
-         long orig_cost = mcf.run_cs2();
+      }
+      for(int i=0; i<3; ++i) {
+         mcf.add_node_excess(i,1);
+         mcf.add_node_excess(3+i,-1);
+      }
+      const long orig_cost = mcf.solve();
 
-         // read out solutions
-         std::vector<int> flow(num_arcs);
-         for(int i=0; i<num_arcs; ++i) {
-            flow[i] = mcf.get_flow(i);
-         }
+      // read out solutions
+      std::vector<int> flow(num_arcs);
+      for(int i=0; i<num_arcs; ++i) {
+         flow[i] = mcf.flow(2*i);
+      }
 
-         REQUIRE(flow[0] + flow[1] + flow[2] == 1);
-         for(int i=0; i<3; ++i) {
-            if(flow[i] == 1) { // increase cost by one and check whether cost of optimal solution is also increased by one
-               mcf.update_cost(i, mcf.get_cost(i) + 2);
-            }
+      test(flow[0] + flow[1] + flow[2] == 1);
+      for(int i=0; i<3; ++i) {
+         if(flow[i] == 1) { // increase cost by two and check whether cost of optimal solution is increased by at most two
+            mcf.update_cost(2*i, 2);
          }
-         long new_cost = mcf.cs2_cost_restart();
-         REQUIRE(orig_cost <= new_cost);
-         REQUIRE(new_cost <= orig_cost + 2);
       }
+      const long new_cost = mcf.resolve();
+      test(orig_cost <= new_cost);
+      test(new_cost <= orig_cost + 2);
+      test(new_cost == mcf.objective());
+      test(mcf.TestOptimality());
+
+      SSP<long,long> cold( num_nodes, num_arcs);
+      for(int e=0; e<num_arcs; ++e) {
+         cold.add_edge(e/3, 3+e%3, 0, 1, mcf.cost(2*e));
+      }
+      for(int i=0; i<3; ++i) {
+         cold.add_node_excess(i,1);
+         cold.add_node_excess(3+i,-1);
+      }
+      test(cold.solve() == new_cost);
    }
-   */
 
-   SECTION( "capacity update" ) {
-      for(int run =0; run<100; ++run) {
-         const int num_nodes = 6;
-         const int num_arcs = 9;
-         MCMF_CS2_STAT<> mcf( num_nodes, num_arcs);
+   // capacity and excess update
+   for(int run =0; run<100; ++run) {
+      const int num_nodes = 6;
+      const int num_arcs = 9;
+      SSP<long,long> mcf( num_nodes, num_arcs);
 
-         for(int i=0; i<3; ++i) {
-            for(int j=0; j<3; ++j) {
-               mcf.set_arc(i,3+j,0,1,uni(rng));
-            }
-         }
-         for(int i=0; i<3; ++i) {
-            mcf.set_excess(i,1);
-            mcf.set_excess(3+i,-1);
+      for(int i=0; i<3; ++i) {
+         for(int j=0; j<3; ++j) {
+            mcf.add_edge(i,3+j,0,1,uni(rng));
          }
-         long orig_cost = mcf.run_cs2();
-         std::vector<int> flow(num_arcs);
-         for(int i=0; i<num_arcs; ++i) {
-            flow[i] = mcf.get_flow(i);
-         }
-
+      }
+      for(int i=0; i<3; ++i) {
+         mcf.add_node_excess(i,1);
+         mcf.add_node_excess(3+i,-1);
+      }
+      const long orig_cost = mcf.solve();
+      std::vector<int> flow(num_arcs);
+      for(int i=0; i<num_arcs; ++i) {
+         flow[i] = mcf.flow(2*i);
+      }
 
-         for(int i=0; i<3; ++i) {
-            for(int j=0; j<3; ++j) {
-               mcf.set_cap(3*i + j, 2);
-            }
-         }
-         for(int i=0; i<3; ++i) {
-            mcf.inc_excess(i,1);
-            mcf.inc_excess(3+i,-1);
+      for(int i=0; i<3; ++i) {
+         for(int j=0; j<3; ++j) {
+            mcf.update_capacity(2*(3*i + j), 1);
          }
+      }
+      for(int i=0; i<3; ++i) {
+         mcf.add_node_excess(i,1);
+         mcf.add_node_excess(3+i,-1);
+      }
+
+      const long new_cost = mcf.resolve();
+      for(int i=0; i<num_arcs; ++i) {
+         test(2*flow[i] == mcf.flow(2*i));
+      }
+      test(mcf.objective() == new_cost);
+      test(2*orig_cost == new_cost);
 
-         long new_cost = mcf.cs2_restart();
-         for(int i=0; i<num_arcs; ++i) {
-            REQUIRE(2*flow[i] == mcf.get_flow(i));
+      // take capacity away from a used arc again
+      for(int i=0; i<num_arcs; ++i) {
+         if(flow[i] == 1) {
+            mcf.update_capacity(2*i, -2);
+            break;
          }
-         auto nc = mcf.compute_objective_cost();
-         assert(nc == new_cost);
-         assert(2*orig_cost == new_cost);
-         REQUIRE(2*orig_cost == new_cost);
       }
+      const long reduced_cost = mcf.resolve();
+      test(reduced_cost >= new_cost);
+      test(reduced_cost == mcf.objective());
+      test(mcf.TestOptimality());
    }
 }
@@ -0,0 +1,81 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+#include <random>
+
+using namespace MCF;
+
+// report memory used by 32 and 64 bit indices and check that both give the same solution.
+// Only the index fields shrink, so with 8 byte costs an arc with its capacity goes from 52 to 36 bytes,
+// about 30% less rather than half.
+template<typename CostType>
+CostType compare_index_types(const std::string& filename, SSP<int,CostType>& f32)
+{
+  auto f64 = load_dimacs_file<int,CostType,BinaryHeap,std::uint64_t>(filename);
+
+  const std::size_t bytes32 = f32.memory_footprint();
+  const std::size_t bytes64 = f64.memory_footprint();
+  std::cout << "nodes = " << f32.no_nodes() << ", arcs = " << f32.no_arcs()
+    << ", 32 bit indices: " << bytes32 << " bytes (" << double(bytes32)/f32.no_arcs() << " per arc)"
+    << ", 64 bit indices: " << bytes64 << " bytes (" << double(bytes64)/f64.no_arcs() << " per arc)"
+    << ", saving " << 100.0*(bytes64 - bytes32)/bytes64 << "%\n";
+  test(bytes32 < bytes64);
+
+  f32.order();
+  f64.order();
+  const CostType objective = f32.solve();
+  test(f64.solve() == objective);
+  for(std::size_t e=0; e<f32.no_arcs(); ++e) {
+    test(f32.flow(e) == f64.flow(e));
+  }
+  return objective;
+}
+
+int main()
+{
+  for(auto e : gte) {
+    std::cout << "testing " << e.file << "\n";
+    test_instance<long>(e.file, e.objective, [&](SSP<int,long>& f) { return compare_index_types(e.file, f); });
+    test_instance<double>(e.file, e.objective, [&](SSP<int,double>& f) { return compare_index_types(e.file, f); });
+  }
+
+  // too many nodes for the index type
+  bool thrown = false;
+  try {
+    SSP<int,long,BinaryHeap,std::uint8_t> f(300, 10);
+  } catch(const std::length_error&) {
+    thrown = true;
+  }
+  test(thrown);
+
+  // with 8 bit indices the flags of Dijkstra and BlockingFlow run out many times
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<long> uni(0,100);
+  SSP<int,long,RadixHeap,std::uint8_t> f8;
+  SSP<int,long,RadixHeap,std::uint8_t> f8_primal_dual;
+  for(int run=0; run<100; ++run) {
+    const int n = 10;
+    SSP<int,long> reference(2*n, n*n);
+    f8.reset(2*n, n*n);
+    f8_primal_dual.reset(2*n, n*n);
+    for(int i=0; i<n; ++i) {
+      for(int j=0; j<n; ++j) {
+        const long c = uni(rng);
+        reference.add_edge(i, n+j, 0, 1, c);
+        f8.add_edge(i, n+j, 0, 1, c);
+        f8_primal_dual.add_edge(i, n+j, 0, 1, c);
+      }
+      for(int k : {i, n+i}) {
+        const int excess = k < n ? 1 : -1;
+        reference.add_node_excess(k, excess);
+        f8.add_node_excess(k, excess);
+        f8_primal_dual.add_node_excess(k, excess);
+      }
+    }
+    const long obj = reference.solve();
+    test(f8.solve() == obj);
+    test(f8.TestOptimality());
+    test(f8_primal_dual.solve_primal_dual() == obj);
+    test(f8_primal_dual.TestOptimality());
+  }
+}
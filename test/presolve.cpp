@@ -0,0 +1,144 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+#include <random>
+#include <vector>
+
+using namespace MCF;
+
+typedef BatchProblem<long,long> problem;
+
+// flows within bounds, flow conservation, complementary slackness and objective
+void test_solution(const problem& p, const BatchSolution<long,long>& s, const long objective)
+{
+   test(s.flow.size() == p.tails.size());
+   test(s.potential.size() == p.no_nodes);
+   std::vector<long> excess = p.excess;
+   long c = 0;
+   for(std::size_t e=0; e<p.tails.size(); ++e) {
+      const long f = s.flow[e];
+      test(f >= p.lower[e] && f <= p.upper[e]);
+      excess[p.tails[e]] -= f;
+      excess[p.heads[e]] += f;
+      c += f*p.cost[e];
+      if(p.tails[e] == p.heads[e]) { continue; }
+      const long reduced_cost = p.cost[e] + s.potential[p.heads[e]] - s.potential[p.tails[e]];
+      test(reduced_cost >= 0 || f == p.upper[e]);
+      test(reduced_cost <= 0 || f == p.lower[e]);
+   }
+   test(std::all_of(excess.begin(), excess.end(), [](const long x) { return x == 0; }));
+   test(c == s.objective);
+   test(c == objective);
+}
+
+// random feasible problem with several components, each a random tree with chains of degree 2 nodes,
+// a few extra arcs and copies of arcs with equal or different cost in either direction
+problem random_problem(const std::size_t no_components, const std::size_t n, std::mt19937& rng)
+{
+   std::uniform_int_distribution<long> cost(-20, 100);
+   std::uniform_int_distribution<long> capacity(1, 10);
+   problem p;
+   auto add_arc = [&](const std::size_t i, const std::size_t j, const long upper, const long c) {
+      p.tails.push_back(i);
+      p.heads.push_back(j);
+      p.lower.push_back(0);
+      p.upper.push_back(upper);
+      p.cost.push_back(c);
+   };
+   for(std::size_t k=0; k<no_components; ++k) {
+      const std::size_t first = p.no_nodes;
+      p.no_nodes += n;
+      auto node = [&]() { return first + rng()%n; };
+      for(std::size_t i=first+1; i<first+n; ++i) {
+         const std::size_t j = first + rng()%(i-first);
+         if(rng()%2) { add_arc(i, j, capacity(rng), cost(rng)); }
+         else { add_arc(j, i, capacity(rng), cost(rng)); }
+      }
+      for(std::size_t e=0; e<n/4; ++e) {
+         const std::size_t i = node(), j = node();
+         if(i != j) { add_arc(i, j, capacity(rng), cost(rng)); }
+      }
+      // chain of new nodes between two existing ones
+      std::size_t i = node();
+      const std::size_t chain_end = node();
+      for(std::size_t l=0; l<5; ++l) {
+         const std::size_t j = p.no_nodes++;
+         if(rng()%3) { add_arc(i, j, capacity(rng), cost(rng)); }
+         else { add_arc(j, i, capacity(rng), cost(rng)); }
+         i = j;
+      }
+      add_arc(i, chain_end, capacity(rng), cost(rng));
+   }
+   const std::size_t m = p.tails.size();
+   for(std::size_t e=0; e<m/3; ++e) {
+      const std::size_t a = rng()%m;
+      switch(rng()%3) {
+         case 0: add_arc(p.tails[a], p.heads[a], capacity(rng), p.cost[a]); break;
+         case 1: add_arc(p.heads[a], p.tails[a], capacity(rng), -p.cost[a]); break;
+         case 2: add_arc(p.tails[a], p.heads[a], capacity(rng), cost(rng)); break;
+      }
+   }
+
+   // excesses of a flow within the bounds
+   p.excess.assign(p.no_nodes, 0);
+   for(std::size_t e=0; e<p.tails.size(); ++e) {
+      const long f = rng()%(p.upper[e]+1);
+      p.excess[p.tails[e]] += f;
+      p.excess[p.heads[e]] -= f;
+   }
+   return p;
+}
+
+void test_presolve(const problem& p, const long objective)
+{
+   const Presolve<long,long> presolve(p);
+   std::cout << "nodes " << p.no_nodes << " -> " << presolve.no_reduced_nodes() << ", edges " << p.tails.size() << " -> " << presolve.no_reduced_edges()
+      << ", components: " << presolve.components().size() << "\n";
+   test(presolve.no_reduced_nodes() <= p.no_nodes);
+   test(presolve.no_reduced_edges() <= p.tails.size());
+   // lower bounds of merged and contracted arcs have been moved into the excesses
+   for(const auto& c : presolve.components()) {
+      test(std::all_of(c.lower.begin(), c.lower.end(), [](const long l) { return l == 0; }));
+   }
+   for(const std::size_t no_threads : {1, 3}) {
+      test_solution(p, presolve.postsolve(solve_batch(presolve.components(), no_threads)), objective);
+   }
+   test_solution(p, solve_presolved(p), objective);
+}
+
+int main()
+{
+   std::mt19937 rng(0);
+   for(int run=0; run<100; ++run) {
+      const problem p = random_problem(1 + rng()%4, 2 + rng()%20, rng);
+      test_presolve(p, solve_batch(std::vector<problem>{p}, 1)[0].objective);
+   }
+
+   for(auto e : gte) {
+      std::cout << "testing " << e.file << "\n";
+      test_presolve(read_dimacs_problem(e.file), e.objective);
+   }
+
+   // self loops and arcs without capacity are removed, a tree is solved without any component left
+   problem p;
+   p.no_nodes = 4;
+   p.tails = {0, 1, 1, 2, 3, 2};
+   p.heads = {1, 1, 2, 3, 2, 2};
+   p.lower = {0, 0, 0, 0, 0, 0};
+   p.upper = {5, 3, 5, 0, 5, 4};
+   p.cost = {1, -2, 1, 7, 1, 3};
+   p.excess = {2, 0, 0, -2};
+   bool thrown = false;
+   try { Presolve<long,long> infeasible(p); } catch(const std::runtime_error&) { thrown = true; }
+   test(thrown);
+   p.excess = {2, 0, -2, 0};
+   const Presolve<long,long> presolve(p);
+   test(presolve.components().empty());
+   test_solution(p, presolve.postsolve({}), 2 + 2 - 6);
+
+   // forced flow exceeding the capacity of a leaf arc
+   p.excess = {6, 0, -6, 0};
+   thrown = false;
+   try { Presolve<long,long> infeasible(p); } catch(const std::runtime_error&) { thrown = true; }
+   test(thrown);
+}
@@ -0,0 +1,52 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+#include <random>
+
+using namespace MCF;
+
+int main()
+{
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<long> uni(0,100);
+
+  test_assignment_problems(rng, [](SSP<long,long>& f) { return f.solve_primal_dual(); });
+
+  // transportation problems with negative costs
+  for(int run=0; run<20; ++run) {
+    const int n = 20;
+    SSP<long,long> mcf(2*n, n*n + n);
+    for(int i=0; i<n; ++i) {
+      for(int j=0; j<n; ++j) {
+        mcf.add_edge(i, n+j, 0, 1 + uni(rng), uni(rng)-20);
+      }
+    }
+    for(int i=0; i<n; ++i) {
+      // supply never exceeds the capacity into any sink, hence the problem is feasible
+      mcf.add_node_excess(i, 10);
+      mcf.add_node_excess(n+i, -10);
+    }
+    for(int i=0; i<n; ++i) {
+      mcf.add_edge(i, n+i, 0, 10, 1000);
+    }
+    SSP<long,long> mcf_pd(mcf);
+    const long obj = mcf.solve();
+    test(mcf_pd.solve_primal_dual() == obj);
+    test(mcf_pd.TestOptimality());
+  }
+
+  test_instances(gte, [](auto& f) { return f.solve_primal_dual(); });
+
+  // infeasible problems are reported instead of returning a partial flow:
+  // excess exceeding the capacity towards the deficit, and deficit exceeding the supply
+  for(const long deficit : {-2l, -3l}) {
+    SSP<long,long> mcf(3, 2);
+    mcf.add_edge(0, 1, 0, 5, 1);
+    mcf.add_edge(1, 2, 0, deficit == -2 ? 1 : 5, 1);
+    mcf.add_node_excess(0, 2);
+    mcf.add_node_excess(2, deficit);
+    bool thrown = false;
+    try { mcf.solve_primal_dual(); } catch(const std::runtime_error&) { thrown = true; }
+    test(thrown);
+  }
+}
@@ -0,0 +1,74 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+#include <random>
+
+using namespace MCF;
+
+// heap_ptr as narrow as the index type of SSP
+template<typename INDEX> struct basic_node { INDEX heap_ptr; long key; };
+
+// monotone sequence of operations as issued by Dijkstra's algorithm
+template<template<typename,typename> class PriorityQueue, typename INDEX = std::size_t>
+void test_queue()
+{
+  using node = basic_node<INDEX>;
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<long> uni(0,1000);
+  std::vector<node> nodes(1000);
+  PriorityQueue<node,long> queue;
+  for(int run=0; run<10; ++run) {
+    queue.Reset();
+    for(auto& n : nodes) { n.key = -1; }
+    long last = 0;
+    queue.Add(&nodes[0], 0);
+    nodes[0].key = 0;
+    long key;
+    node* i;
+    while( (i = queue.RemoveMin(key)) ) {
+      test(key >= last);
+      test(key == i->key);
+      last = key;
+      i->key = -2; // permanent
+      for(int k=0; k<5; ++k) {
+        node& j = nodes[uni(rng) % nodes.size()];
+        if(j.key == -2) continue;
+        const long d = key + uni(rng);
+        if(j.key == -1) { queue.Add(&j, d); j.key = d; }
+        else if(d < queue.GetKey(&j)) { queue.DecreaseKey(&j, d); j.key = d; }
+        test(queue.GetKey(&j) == j.key);
+      }
+    }
+  }
+}
+
+template<typename CostType, template<typename,typename> class PriorityQueue>
+void test_queue_instance(const std::string& filename, const long mcf_cost)
+{
+  auto* f = read_dimacs_file<int,CostType,PriorityQueue>(filename);
+  auto* f_csr = new SSP<int,CostType,PriorityQueue>(*f);
+  test(f->solve() == mcf_cost);
+  test(f->TestOptimality());
+  test(f_csr->solve_csr() == mcf_cost);
+  test(f_csr->TestOptimality());
+  delete f;
+  delete f_csr;
+}
+
+int main()
+{
+  test_queue<BinaryHeap>();
+  test_queue<QuaternaryHeap>();
+  test_queue<RadixHeap>();
+  test_queue<BinaryHeap,std::uint16_t>();
+  test_queue<QuaternaryHeap,std::uint16_t>();
+  test_queue<RadixHeap,std::uint16_t>();
+
+  for(auto e : gte) {
+    std::cout << "testing " << e.file << "\n";
+    test_queue_instance<long,BinaryHeap>(e.file, e.objective);
+    test_queue_instance<long,QuaternaryHeap>(e.file, e.objective);
+    test_queue_instance<long,RadixHeap>(e.file, e.objective);
+    test_queue_instance<double,QuaternaryHeap>(e.file, e.objective);
+  }
+}
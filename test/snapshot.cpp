@@ -0,0 +1,88 @@
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+
+using namespace MCF;
+
+const std::string snapshot = "snapshot_test.bin";
+
+// solve, save and restore: the restored network has the same graph, flow and potentials
+template<typename SOLVER>
+auto solve_and_restore(SOLVER& f)
+{
+  f.solve();
+  f.save_snapshot(snapshot);
+  SOLVER g;
+  g.load_snapshot(snapshot);
+  test(g.no_nodes() == f.no_nodes());
+  test(g.no_edges() == f.no_edges());
+  for(std::size_t e=0; e<f.no_arcs(); ++e) {
+    test(g.flow(e) == f.flow(e));
+    test(g.cost(e) == f.cost(e));
+    test(g.tail(e) == f.tail(e));
+    test(g.head(e) == f.head(e));
+  }
+  for(std::size_t i=0; i<f.no_nodes(); ++i) {
+    test(g.potential(i) == f.potential(i));
+  }
+  swap(f, g);
+  return f.objective();
+}
+
+// partially solved network: warm start from the snapshot
+template<typename CostType>
+void test_warm_start(const std::string& filename)
+{
+  auto f = load_dimacs_file<int,CostType>(filename);
+  f.solve();
+  f.update_cost(0, 100000);
+  f.add_node_excess(0, 10);
+  f.add_node_excess(f.no_nodes()-1, -10);
+  f.save_snapshot(snapshot);
+  SSP<int,CostType> g;
+  g.load_snapshot(snapshot);
+  const CostType obj = f.resolve();
+  test(g.resolve() == obj);
+  test(g.objective() == f.objective());
+  test(g.TestOptimality());
+}
+
+void test_error(const std::string& snapshot)
+{
+  bool thrown = false;
+  try {
+    SSP<int,long> f;
+    f.load_snapshot(snapshot);
+  } catch(const std::runtime_error& e) {
+    std::cout << e.what() << "\n";
+    thrown = true;
+  }
+  test(thrown);
+}
+
+int main()
+{
+  test_instances(gte, [](auto& f) { return solve_and_restore(f); });
+  for(auto e : gte) {
+    test_warm_start<long>(e.file);
+    test_warm_start<double>(e.file);
+  }
+
+  // type mismatch, truncation and garbage are detected
+  auto f = load_dimacs_file<int,double>(gte[0].file);
+  f.save_snapshot(snapshot);
+  test_error(snapshot);
+
+  auto g = load_dimacs_file<int,long>(gte[0].file);
+  g.save_snapshot(snapshot);
+  std::string content;
+  {
+    std::ifstream in(snapshot, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  { std::ofstream out(snapshot, std::ios::binary); out << content.substr(0, content.size()/2); }
+  test_error(snapshot);
+  { std::ofstream out(snapshot, std::ios::binary); out << "c this is not a snapshot"; }
+  test_error(snapshot);
+  std::remove(snapshot.c_str());
+}
@@ -0,0 +1,79 @@
+#define SSP_STATISTICS
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+
+using namespace MCF;
+
+int main()
+{
+  for(auto e : gte) {
+    auto f = load_dimacs_file<int,long>(e.file);
+    std::size_t iterations = 0, nodes_settled = 0, arcs_relaxed = 0, augmentations = 0, path_arcs = 0;
+    long flow = 0;
+    f.set_trace([&](const SSP<int,long>::Iteration& it) {
+      test(it.start < f.no_nodes());
+      test(it.augmentations <= 1);
+      iterations++;
+      nodes_settled += it.nodes_settled;
+      arcs_relaxed += it.arcs_relaxed;
+      augmentations += it.augmentations;
+      path_arcs += it.path_arcs;
+      flow += it.delta;
+    });
+    f.order();
+    test(f.solve() == e.objective);
+
+    const auto& s = f.statistics();
+    std::cout << e.file << ": " << s.dijkstra_calls << " Dijkstra calls, " << s.nodes_settled << " nodes settled, "
+      << s.arcs_relaxed << " arcs relaxed, " << s.augmentations << " augmentations of average length "
+      << double(s.augmenting_path_arcs)/s.augmentations << ", " << s.presaturated_arcs << " arcs presaturated, "
+      << 1000.0*s.main_loop_seconds << " ms in main loop\n";
+    test(s.dijkstra_calls == iterations);
+    test(s.nodes_settled == nodes_settled);
+    test(s.arcs_relaxed == arcs_relaxed);
+    test(s.augmentations == augmentations);
+    test(s.augmenting_path_arcs == path_arcs);
+    test(s.augmented_flow == flow);
+    test(s.augmentations > 0 && s.augmentations <= s.dijkstra_calls);
+    test(s.max_augmenting_path_arcs > 0 && s.max_augmenting_path_arcs < f.no_nodes());
+    // every node taken from the heap is either settled or the end of an augmenting path
+    test(s.heap_remove_mins == s.nodes_settled + s.augmentations);
+    test(s.heap_adds >= s.heap_remove_mins);
+    test(s.order_seconds > 0.0 && s.init_seconds > 0.0 && s.main_loop_seconds > 0.0);
+
+    // statistics accumulate over warm starts until reset
+    f.reset_statistics();
+    test(f.statistics().dijkstra_calls == 0);
+    f.add_node_excess(0, 1);
+    f.add_node_excess(f.no_nodes()-1, -1);
+    f.resolve();
+    test(f.statistics().dijkstra_calls > 0);
+    test(f.statistics().order_seconds == 0.0);
+
+    // primal-dual runs one iteration per phase, started from all active nodes
+    auto g = load_dimacs_file<int,long>(e.file);
+    std::size_t phases = 0;
+    g.set_trace([&](const SSP<int,long>::Iteration& it) {
+      test(it.start == g.no_nodes());
+      test(it.augmentations > 0);
+      phases++;
+    });
+    test(g.solve_primal_dual() == e.objective);
+    test(g.statistics().dijkstra_calls == phases);
+
+    // cost scaling leaves nothing to the successive shortest path cleanup for costs with integer values
+    auto h = load_dimacs_file<int,double>(e.file);
+    test(h.solve_cost_scaling() == e.objective);
+    test(h.statistics().refine_phases > 0);
+    test(h.statistics().dijkstra_calls == 0);
+
+    // an optimal flow is kept and needs a single phase to confirm
+    auto k = load_dimacs_file<int,long>(e.file);
+    k.solve_cost_scaling();
+    test(k.statistics().refine_phases > 1);
+    k.reset_statistics();
+    test(k.solve_cost_scaling() == e.objective);
+    test(k.statistics().refine_phases == 1);
+  }
+}
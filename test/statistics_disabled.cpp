@@ -0,0 +1,28 @@
+// without SSP_STATISTICS the instrumentation is compiled out
+#include "../mcf_ssp.hxx"
+#include "instances.h"
+#include "test.h"
+
+using namespace MCF;
+
+int main()
+{
+  for(auto e : gte) {
+    auto f = load_dimacs_file<int,long>(e.file);
+    std::size_t calls = 0;
+    f.set_trace([&](const SSP<int,long>::Iteration&) { calls++; });
+    f.order();
+    test(f.solve() == e.objective);
+    test(f.solve_primal_dual() == e.objective);
+    test(f.solve_cost_scaling() == e.objective);
+    test(calls == 0);
+
+    const auto& s = f.statistics();
+    test(s.dijkstra_calls == 0 && s.nodes_settled == 0 && s.arcs_relaxed == 0);
+    test(s.heap_adds == 0 && s.heap_decrease_keys == 0 && s.heap_remove_mins == 0);
+    test(s.augmentations == 0 && s.augmenting_path_arcs == 0 && s.max_augmenting_path_arcs == 0);
+    test(s.augmented_flow == 0 && s.max_augmented_flow == 0);
+    test(s.presaturated_arcs == 0 && s.refine_phases == 0);
+    test(s.order_seconds == 0.0 && s.init_seconds == 0.0 && s.main_loop_seconds == 0.0);
+  }
+}
@@ -1,4 +1,7 @@
 #include "../mcf_ssp.hxx"
+#include <fstream>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 
@@ -8,18 +11,96 @@ inline void test(const bool& pred)
     throw std::runtime_error("Test failed.");
 }
 
-template<typename CostType>
-void test_instance(const std::string& filename, const long mcf_cost)
+// load a DIMACS instance, solve it with solve(f) and check the solution against the known objective
+template<typename CostType, typename SOLVE>
+void test_instance(const std::string& filename, const long mcf_cost, SOLVE&& solve)
 {
-  auto* f = MCF::read_dimacs_file<int,CostType>(filename);
-  f->order();
-  auto objective = f->solve();
+  auto f = MCF::load_dimacs_file<int,CostType>(filename);
+  const CostType objective = solve(f);
   std::cout << "objective value = " << objective << "\n";
-  //f->print_flow();
-  test(f->TestOptimality());
-  test(objective == f->objective());
+  test(f.TestOptimality());
+  test(f.TestCosts());
+  test(objective == f.objective());
   test(objective == mcf_cost);
-  //test(f->TestCosts());
-  delete f;
 }
 
+template<typename CostType>
+void test_instance(const std::string& filename, const long mcf_cost)
+{
+  test_instance<CostType>(filename, mcf_cost, [](auto& f) { f.order(); return f.solve(); });
+}
+
+// every instance with integer and floating point costs. solve is called as solve(f) with SSP<int,long> and SSP<int,double>
+template<typename INSTANCES, typename SOLVE>
+void test_instances(const INSTANCES& instances, SOLVE&& solve)
+{
+  for(const auto& e : instances) {
+    std::cout << "testing " << e.file << "\n";
+    test_instance<long>(e.file, e.objective, solve);
+    test_instance<double>(e.file, e.objective, solve);
+  }
+}
+
+// random 50 x 50 assignment problems: solve(f) on a copy must reproduce the objective of solve() with 0/1 flows
+template<typename SOLVE>
+void test_assignment_problems(std::mt19937& rng, SOLVE&& solve)
+{
+  std::uniform_int_distribution<long> uni(0,100);
+  for(int run=0; run<20; ++run) {
+    const int n = 50;
+    MCF::SSP<long,long> mcf(2*n, n*n);
+    for(int i=0; i<n; ++i) {
+      for(int j=0; j<n; ++j) {
+        mcf.add_edge(i, n+j, 0, 1, uni(rng));
+      }
+    }
+    for(int i=0; i<n; ++i) {
+      mcf.add_node_excess(i, 1);
+      mcf.add_node_excess(n+i, -1);
+    }
+    MCF::SSP<long,long> f(mcf);
+    const long obj = mcf.solve();
+    test(solve(f) == obj);
+    test(f.objective() == obj);
+    test(f.TestOptimality());
+    for(std::size_t e=0; e<f.no_edges(); ++e) {
+      test(f.flow(2*e) == 0 || f.flow(2*e) == 1);
+    }
+  }
+}
+
+
+// plain reader for the node and arc lines of a DIMACS file, nodes are renumbered from 0
+inline MCF::BatchProblem<long,long> read_dimacs_problem(const std::string& filename)
+{
+  std::ifstream in(filename);
+  test(in.is_open());
+  MCF::BatchProblem<long,long> p;
+  std::string line;
+  while(std::getline(in, line)) {
+    std::istringstream s(line);
+    char id;
+    if(!(s >> id)) continue;
+    if(id == 'p') {
+      std::string min;
+      std::size_t m;
+      s >> min >> p.no_nodes >> m;
+      p.excess.assign(p.no_nodes, 0);
+    } else if(id == 'n') {
+      std::size_t i;
+      long supply;
+      s >> i >> supply;
+      p.excess[i-1] = supply;
+    } else if(id == 'a') {
+      std::size_t i, j;
+      long lower, upper, cost;
+      s >> i >> j >> lower >> upper >> cost;
+      p.tails.push_back(i-1);
+      p.heads.push_back(j-1);
+      p.lower.push_back(lower);
+      p.upper.push_back(upper);
+      p.cost.push_back(cost);
+    }
+  }
+  return p;
+}